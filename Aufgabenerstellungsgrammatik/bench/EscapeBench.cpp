@@ -0,0 +1,136 @@
+// ============================================================================
+// File: bench/EscapeBench.cpp
+// Microbenchmark: legacy per-byte ostream escaping vs. scalar/vectorized scan
+// ============================================================================
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "domain/JsonEscape.h"
+
+// The former DomainJson escapeJson: one switch and one stream call per byte
+static void escapeLegacy(const std::string& in, std::ostream& os) {
+    for (char c : in) {
+        switch (c) {
+        case '\"': os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '\n': os << "\\n";  break;
+        case '\r': os << "\\r";  break;
+        case '\t': os << "\\t";  break;
+        default:   os << c;      break;
+        }
+    }
+}
+
+template <class Find>
+static void escapeRuns(const std::string& in, std::string& out, Find find) {
+    const char* p = in.data();
+    size_t n = in.size();
+    char seq[6];
+    while (n > 0) {
+        const size_t clean = find(p, n);
+        out.append(p, clean);
+        if (clean == n) break;
+        out.append(seq, jsonEscapeSequence(p[clean], seq));
+        p += clean + 1;
+        n -= clean + 1;
+    }
+}
+
+// German prose with umlauts, roughly the shape of task texts; `dirtyEvery` > 0
+// puts a quote into every n-th string.
+static std::vector<std::string> makeCorpus(size_t count, size_t dirtyEvery) {
+    static const char* words[] = {"Ordne", "die", "Hauptstadt", "dem", "Land", "zu",
+                                  "L\xC3\xBC" "ckentext", "Stra\xC3\x9F" "e", "f\xC3\xBCr",
+                                  "Gr\xC3\xB6\xC3\x9F" "e", "Niklas", "ist", "ein", "toller", "Mensch"};
+    std::mt19937 rng(42);
+    std::vector<std::string> out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string s;
+        const size_t n = 2 + rng() % 14;
+        for (size_t w = 0; w < n; ++w) {
+            if (w) s += ' ';
+            s += words[rng() % (sizeof(words) / sizeof(words[0]))];
+        }
+        if (dirtyEvery && i % dirtyEvery == 0) s.insert(s.size() / 2, "\"");
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+template <class Fn>
+static double bestMillis(Fn fn, int reps) {
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        const auto t0 = std::chrono::steady_clock::now();
+        fn();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+static bool checkAgainstScalar() {
+    std::mt19937 rng(7);
+    for (int iter = 0; iter < 20000; ++iter) {
+        std::string s(rng() % 100, 'a');
+        for (char& c : s) c = static_cast<char>(0x20 + rng() % 0xE0); // printable + UTF-8 bytes, no ctrl
+        if (!s.empty() && rng() % 2) s[rng() % s.size()] = "\"\\\x01\x1F"[rng() % 4];
+        for (size_t off = 0; off < s.size(); ++off) {
+            if (findJsonEscape(s.data() + off, s.size() - off) !=
+                findJsonEscapeScalar(s.data() + off, s.size() - off)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const int reps = 5;
+
+    if (!checkAgainstScalar()) {
+        std::fprintf(stderr, "findJsonEscape (%s) disagrees with the scalar reference\n", jsonEscapeImpl());
+        return 1;
+    }
+
+    std::printf("impl=%s strings=%zu\n", jsonEscapeImpl(), count);
+    for (size_t dirty : {size_t(0), size_t(10)}) {
+        const auto corpus = makeCorpus(count, dirty);
+        size_t bytes = 0;
+        for (const auto& s : corpus) bytes += s.size();
+
+        std::string legacyOut, scalarOut, simdOut;
+        const double legacy = bestMillis([&] {
+            std::ostringstream os;
+            for (const auto& s : corpus) escapeLegacy(s, os);
+            legacyOut = os.str();
+        }, reps);
+        const double scalar = bestMillis([&] {
+            scalarOut.clear();
+            for (const auto& s : corpus) escapeRuns(s, scalarOut, findJsonEscapeScalar);
+        }, reps);
+        const double simd = bestMillis([&] {
+            simdOut.clear();
+            for (const auto& s : corpus) escapeRuns(s, simdOut, findJsonEscape);
+        }, reps);
+
+        if (legacyOut != scalarOut || scalarOut != simdOut) {
+            std::fprintf(stderr, "outputs differ\n");
+            return 1;
+        }
+
+        const double mb = bytes / (1024.0 * 1024.0);
+        std::printf("%-14s %8.2f MiB  legacy %8.2f ms (%7.1f MiB/s)  scalar %8.2f ms (%7.1f MiB/s)"
+                    "  %s %8.2f ms (%7.1f MiB/s)\n",
+                    dirty ? "quote/10 str" : "clean", mb, legacy, mb / (legacy / 1000.0), scalar,
+                    mb / (scalar / 1000.0), jsonEscapeImpl(), simd, mb / (simd / 1000.0));
+    }
+    return 0;
+}
@@ -0,0 +1,331 @@
+// ============================================================================
+// File: bench/GradeBench.cpp
+// Microbenchmark: Auswahl/RoF scoring (flags vs. packed answer keys) and
+// tolerant free-text matching (DP Levenshtein vs. bit-parallel Myers)
+// ============================================================================
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "grading/AnswerKey.h"
+#include "grading/TextMatch.h"
+
+namespace {
+
+constexpr size_t kPool = 4096; // distinct synthetic responses, cycled
+
+// The JSON reader hands the grader picks as indices or texts; the packed
+// forms are what Grader builds from them before scoring.
+struct ChoiceResponse {
+    std::vector<std::vector<uint32_t>> picks;          // per line: option indices (may repeat)
+    std::vector<std::vector<std::string_view>> texts;  // the same picks as option texts
+    std::vector<uint64_t> selected;                    // packed, lines at ChoiceKey::wordBegin
+};
+
+struct RoFResponse {
+    std::vector<signed char> answers; // per line: -1 unanswered, 0 false, 1 true
+    std::vector<uint64_t> answered;   // packed
+    std::vector<uint64_t> givenTrue;  // packed
+};
+
+// Auswahl lines of 2..12 options, every 8th line with 70 (two bit words)
+ChoiceTaskD makeChoiceTask(size_t lines, std::deque<std::string>& texts, std::mt19937& rng) {
+    ChoiceTaskD task;
+    for (size_t l = 0; l < lines; ++l) {
+        ChoiceLineIR line;
+        const size_t n = l % 8 == 7 ? 70 : 2 + rng() % 11;
+        for (size_t o = 0; o < n; ++o) {
+            ChoiceOptionIR opt;
+            opt.text = texts.emplace_back("Option " + std::to_string(l) + "." + std::to_string(o));
+            opt.points = static_cast<int>(rng() % 6) - 2;
+            opt.isCorrect = opt.points > 0;
+            line.options.push_back(opt);
+        }
+        task.lines.push_back(std::move(line));
+    }
+    return task;
+}
+
+RoFTaskD makeRoFTask(size_t lines, std::mt19937& rng) {
+    RoFTaskD task;
+    for (size_t l = 0; l < lines; ++l) {
+        TrueFalseTaskIR line;
+        line.answer.isTrue = rng() % 2;
+        task.lines.push_back(std::move(line));
+    }
+    return task;
+}
+
+// The former Grader::scoreChoiceLine: text lookup per pick, one flag per option
+int scoreChoiceLegacy(const ChoiceTaskD& task, const ChoiceResponse& r, std::vector<char>& chosen) {
+    int total = 0;
+    for (size_t l = 0; l < task.lines.size(); ++l) {
+        const auto& options = task.lines[l].options;
+        chosen.assign(options.size(), 0);
+        for (std::string_view text : r.texts[l]) {
+            for (size_t k = 0; k < options.size(); ++k) {
+                if (options[k].text == text) {
+                    chosen[k] = 1;
+                    break;
+                }
+            }
+        }
+        int sum = 0;
+        for (size_t k = 0; k < options.size(); ++k) {
+            if (chosen[k]) sum += options[k].points;
+        }
+        total += std::max(sum, 0);
+    }
+    return total;
+}
+
+// Picks by index, one flag per option
+int scoreChoiceFlags(const ChoiceTaskD& task, const ChoiceResponse& r, std::vector<char>& chosen) {
+    int total = 0;
+    for (size_t l = 0; l < task.lines.size(); ++l) {
+        const auto& options = task.lines[l].options;
+        chosen.assign(options.size(), 0);
+        for (uint32_t k : r.picks[l]) chosen[k] = 1;
+        int sum = 0;
+        for (size_t k = 0; k < options.size(); ++k) {
+            if (chosen[k]) sum += options[k].points;
+        }
+        total += std::max(sum, 0);
+    }
+    return total;
+}
+
+template <class Sum>
+int scoreChoiceBits(const ChoiceKey& key, const ChoiceResponse& r, Sum sum) {
+    int total = 0;
+    for (size_t l = 0; l < key.lines(); ++l) total += std::max(sum(key, l, r.selected.data() + key.wordBegin[l]), 0);
+    return total;
+}
+
+int choiceLinePointsScalar(const ChoiceKey& key, size_t line, const uint64_t* selected) {
+    const int32_t* points = key.points.data() + key.pointBegin[line];
+    const size_t lanes = key.pointBegin[line + 1] - key.pointBegin[line];
+    int sum = 0;
+    for (size_t w = 0; w < key.words(line); ++w) {
+        sum += maskedSumScalar(selected[w], points + 64 * w, std::min<size_t>(lanes - 64 * w, 64));
+    }
+    return sum;
+}
+
+int scoreRoFLegacy(const RoFTaskD& task, const RoFResponse& r) {
+    int points = 0;
+    for (size_t l = 0; l < task.lines.size(); ++l) {
+        if (r.answers[l] >= 0 && (r.answers[l] == 1) == task.lines[l].answer.isTrue) ++points;
+    }
+    return points;
+}
+
+// Textbook O(n * m) Levenshtein, what the downstream scripts did per answer
+int levenshteinDp(const std::u32string& a, const std::u32string& b, std::vector<int>& row) {
+    row.resize(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) row[j] = static_cast<int>(j);
+    for (size_t i = 1; i <= a.size(); ++i) {
+        int diag = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= b.size(); ++j) {
+            const int up = row[j];
+            row[j] = std::min({up + 1, row[j - 1] + 1, diag + (a[i - 1] != b[j - 1] ? 1 : 0)});
+            diag = up;
+        }
+    }
+    return row[b.size()];
+}
+
+// Solutions plus answers with 0..3 random edits, umlauts spelled either way
+void makeFreeText(std::vector<std::string>& solutions, std::vector<std::string>& answers,
+                  std::vector<uint32_t>& solutionOf, std::mt19937& rng) {
+    static const char* words[] = {"L\xC3\xBC" "ckentext", "Stra\xC3\x9F" "e", "Gr\xC3\xB6\xC3\x9F" "e",
+                                  "fliegen", "Berlin", "Hauptstadt", "Niederlande", "Photosynthese",
+                                  "Mitochondrien", "\xC3\x9C" "bergangsmetalle", "Schr\xC3\xB6" "dingergleichung",
+                                  "Bundesverfassungsgericht"};
+    static const char* respell[][2] = {{"\xC3\xBC", "ue"}, {"\xC3\xB6", "oe"}, {"\xC3\x9F", "ss"}, {"\xC3\x9C", "Ue"}};
+    for (const char* w : words) solutions.emplace_back(w);
+    for (size_t i = 0; i < kPool; ++i) {
+        const uint32_t s = static_cast<uint32_t>(rng() % solutions.size());
+        std::string a = solutions[s];
+        if (rng() % 2) {
+            for (const auto& r : respell) {
+                for (size_t pos; (pos = a.find(r[0])) != std::string::npos;) a.replace(pos, std::string(r[0]).size(), r[1]);
+            }
+        }
+        for (size_t e = rng() % 4; e > 0 && !a.empty(); --e) {
+            const size_t pos = rng() % a.size();
+            if (static_cast<unsigned char>(a[pos]) >= 0x80) continue; // keep the UTF-8 valid
+            switch (rng() % 3) {
+            case 0: a.erase(pos, 1); break;
+            case 1: a.insert(pos, 1, static_cast<char>('a' + rng() % 26)); break;
+            default: a[pos] = static_cast<char>('a' + rng() % 26); break;
+            }
+        }
+        if (rng() % 3 == 0) a[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(a[0])));
+        answers.push_back(std::move(a));
+        solutionOf.push_back(s);
+    }
+}
+
+template <class Fn>
+double bestMillis(Fn fn, int reps) {
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        const auto t0 = std::chrono::steady_clock::now();
+        fn();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+bool checkAgainstScalar() {
+    std::mt19937_64 rng(7);
+    int32_t points[64];
+    for (int iter = 0; iter < 100000; ++iter) {
+        for (int32_t& p : points) p = static_cast<int32_t>(rng() % 200) - 100;
+        const uint64_t mask = rng() & rng();
+        const size_t lanes = 8 * (1 + rng() % 8);
+        if (maskedSum(mask, points, lanes) != maskedSumScalar(mask, points, lanes)) return false;
+    }
+    return true;
+}
+
+void report(const char* name, size_t count, double ms, long long checksum) {
+    std::printf("  %-14s %9.1f ms  %7.1f M responses/s  (sum %lld)\n", name, ms, count / (ms * 1000.0), checksum);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    const int reps = 3;
+
+    if (!checkAgainstScalar()) {
+        std::fprintf(stderr, "maskedSum (%s) disagrees with the scalar reference\n", answerKeyImpl());
+        return 1;
+    }
+
+    std::mt19937 rng(42);
+    std::deque<std::string> texts;
+    const size_t choiceLines = 8, rofLines = 40;
+    const ChoiceTaskD choice = makeChoiceTask(choiceLines, texts, rng);
+    const RoFTaskD rof = makeRoFTask(rofLines, rng);
+    const AnswerKey choiceKey = buildAnswerKey(TaskD{choice});
+    const AnswerKey rofKey = buildAnswerKey(TaskD{rof});
+
+    std::printf("impl=%s responses=%zu pool=%zu\n", answerKeyImpl(), count, kPool);
+    const auto run = [&](long long& sum, auto score) {
+        return bestMillis([&] {
+            sum = 0;
+            for (size_t i = 0; i < count; ++i) sum += score(i % kPool);
+        }, reps);
+    };
+
+    // sparse: 0..3 picks per line (typical); dense: every option with p = 1/2
+    std::vector<char> flags;
+    for (bool dense : {false, true}) {
+        std::vector<ChoiceResponse> pool(kPool);
+        for (ChoiceResponse& r : pool) {
+            r.selected.assign(choiceKey.choice.correct.size(), 0);
+            for (size_t l = 0; l < choice.lines.size(); ++l) {
+                const auto& options = choice.lines[l].options;
+                auto& picks = r.picks.emplace_back();
+                auto& names = r.texts.emplace_back();
+                if (dense) {
+                    for (uint32_t k = 0; k < options.size(); ++k) {
+                        if (rng() % 2) picks.push_back(k);
+                    }
+                } else {
+                    for (size_t n = rng() % 4; n > 0; --n) picks.push_back(static_cast<uint32_t>(rng() % options.size()));
+                }
+                for (uint32_t k : picks) {
+                    names.push_back(options[k].text);
+                    setBit(r.selected.data() + choiceKey.choice.wordBegin[l], k);
+                }
+            }
+        }
+
+        long long legacySum = 0, flagsSum = 0, scalarSum = 0, simdSum = 0;
+        const double legacy = run(legacySum, [&](size_t i) { return scoreChoiceLegacy(choice, pool[i], flags); });
+        const double byIndex = run(flagsSum, [&](size_t i) { return scoreChoiceFlags(choice, pool[i], flags); });
+        const double scalar = run(scalarSum, [&](size_t i) {
+            return scoreChoiceBits(choiceKey.choice, pool[i], choiceLinePointsScalar);
+        });
+        const double simd = run(simdSum, [&](size_t i) {
+            return scoreChoiceBits(choiceKey.choice, pool[i], choiceLinePoints);
+        });
+        if (legacySum != flagsSum || flagsSum != scalarSum || scalarSum != simdSum) {
+            std::fprintf(stderr, "Auswahl scores differ\n");
+            return 1;
+        }
+        std::printf("Auswahl, %zu lines/response, %s picks\n", choiceLines, dense ? "dense" : "sparse");
+        report("legacy (text)", count, legacy, legacySum);
+        report("flags (index)", count, byIndex, flagsSum);
+        report("bits scalar", count, scalar, scalarSum);
+        report((std::string("bits ") + answerKeyImpl()).c_str(), count, simd, simdSum);
+    }
+
+    std::vector<RoFResponse> rofPool(kPool);
+    for (RoFResponse& r : rofPool) {
+        r.answered.assign(rofKey.rof.words(), 0);
+        r.givenTrue.assign(rofKey.rof.words(), 0);
+        for (size_t l = 0; l < rofLines; ++l) {
+            r.answers.push_back(static_cast<signed char>(rng() % 3) - 1);
+            if (r.answers[l] >= 0) setBit(r.answered.data(), l);
+            if (r.answers[l] == 1) setBit(r.givenTrue.data(), l);
+        }
+    }
+    long long rofLegacySum = 0, rofBitsSum = 0;
+    const double rLegacy = run(rofLegacySum, [&](size_t i) { return scoreRoFLegacy(rof, rofPool[i]); });
+    const double rBits = run(rofBitsSum, [&](size_t i) {
+        return rofPoints(rofKey.rof, rofPool[i].answered.data(), rofPool[i].givenTrue.data());
+    });
+    if (rofLegacySum != rofBitsSum) {
+        std::fprintf(stderr, "RoF scores differ\n");
+        return 1;
+    }
+    std::printf("RoF, %zu lines/response\n", rofLines);
+    report("legacy (bool)", count, rLegacy, rofLegacySum);
+    report("bits popcount", count, rBits, rofBitsSum);
+
+    // Lückentext with --fold --max-edits 2
+    MatchOptions match;
+    match.fold = true;
+    match.maxEdits = 2;
+    std::vector<std::string> solutions, answers;
+    std::vector<uint32_t> solutionOf;
+    makeFreeText(solutions, answers, solutionOf, rng);
+    std::vector<SolutionMatcher> matchers;
+    std::vector<std::u32string> foldedSolutions(solutions.size());
+    for (size_t k = 0; k < solutions.size(); ++k) {
+        matchers.emplace_back(solutions[k], match);
+        foldText(solutions[k], true, foldedSolutions[k]);
+    }
+
+    std::vector<int> row;
+    std::u32string folded;
+    long long dpSum = 0, myersSum = 0;
+    const double tDp = run(dpSum, [&](size_t i) {
+        foldText(answers[i], true, folded);
+        const std::u32string& solution = foldedSolutions[solutionOf[i]];
+        const int limit = std::min(match.maxEdits, static_cast<int>(solution.size()) - 1);
+        return levenshteinDp(solution, folded, row) <= limit ? 1 : 0;
+    });
+    const double tMyers = run(myersSum, [&](size_t i) { return matchers[solutionOf[i]].matches(answers[i]) ? 1 : 0; });
+    if (dpSum != myersSum) {
+        std::fprintf(stderr, "free-text matches differ\n");
+        return 1;
+    }
+    std::printf("Lueckentext, fold + max 2 edits, %zu solutions\n", solutions.size());
+    report("levenshtein dp", count, tDp, dpSum);
+    report("myers", count, tMyers, myersSum);
+    return 0;
+}
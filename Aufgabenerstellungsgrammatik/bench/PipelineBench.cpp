@@ -0,0 +1,525 @@
+// ============================================================================
+// File: bench/PipelineBench.cpp
+// Per-stage pipeline benchmark (replaces perf/run_perf.ps1 and perf/fail_share.ps1)
+// ============================================================================
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "antlr4-runtime.h"
+#include "AufgabenerstellungsgrammatikLexer.h"
+#include "AufgabenerstellungsgrammatikParser.h"
+
+#include "domain/DomainConvert.h"
+#include "domain/DomainJson.h"
+#include "domain/DomainOutput.h"
+#include "domain/JsonSink.h"
+#include "driver/Batch.h"
+#include "driver/Compiler.h"
+#include "driver/SourceFile.h"
+#include "driver/SplitCompile.h"
+#include "ir/IRBuilder.h"
+#include "native/NativeParser.h"
+#include "native/NativeTokenSource.h"
+
+namespace fs = std::filesystem;
+
+// ----------------------------------------------------------------------------
+// Allocation counting: every operator new of the process (the ANTLR runtime
+// included when it is linked as a shared library on Linux; a Windows DLL keeps
+// its own allocator). new[] and the nothrow forms forward to operator new.
+// The benchmark is single-threaded, so plain counters suffice.
+// ----------------------------------------------------------------------------
+static size_t gAllocCount = 0;
+static size_t gAllocBytes = 0;
+
+void* operator new(std::size_t n) {
+    ++gAllocCount;
+    gAllocBytes += n;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum Stage {
+    Read,      // SourceFile: map + encoding detection
+    NativeIr,  // NativeParser: source -> IR (default frontend, no parse tree)
+    Lex,       // whole token stream (--lexer)
+    Parse,     // prog(), SLL + bail, LL only on failure
+    IrBuild,   // IRBuilder: parse tree -> IR
+    Convert,   // convertProgram: IR -> Domain
+    Json,      // domainToJson
+    Pretty,    // prettyJsonDomain
+    Write,     // writeDomainOutput (--format)
+    kStageCount
+};
+
+const char* const kStageNames[kStageCount] = {"read",    "native_parse",   "lex",         "parse", "ir_build",
+                                              "convert", "domain_to_json", "pretty_json", "write"};
+
+struct StageStats {
+    std::vector<double> millis; // one entry per recorded run
+    size_t allocs = 0;
+    size_t allocBytes = 0;
+};
+
+struct Sample {
+    std::string input;
+    std::string output;
+};
+
+struct Failure {
+    std::string input;
+    const char* stage = "";
+    std::string error;
+};
+
+// One run of one sample, committed to the totals only if every stage succeeded
+struct Run {
+    double millis[kStageCount] = {};
+    size_t allocs[kStageCount] = {};
+    size_t allocBytes[kStageCount] = {};
+    size_t tasks = 0;
+    bool nativeRejected = false;
+};
+
+// The pieces of Compiler, driven one stage at a time. Kept warm across runs
+// like Compiler, so the DFA caches are filled after the warm-up pass.
+class Pipeline {
+public:
+    Pipeline(LexerKind lexerKind, OutputFormat outputFormat)
+        : lexer(&inputStream), tokens(&lexer), parser(&tokens),
+          bailStrategy(std::make_shared<antlr4::BailErrorStrategy>()),
+          defaultStrategy(std::make_shared<antlr4::DefaultErrorStrategy>()),
+          lexerKind(lexerKind), format(outputFormat) {
+        lexer.removeErrorListeners();
+        lexer.addErrorListener(&listener);
+        parser.removeErrorListeners();
+        parser.addErrorListener(&listener);
+    }
+
+    // false: `failure` names the stage and the error
+    bool run(const Sample& s, Run& run, Failure& failure);
+
+private:
+    template <class Fn>
+    void timed(Stage stage, Run& run, Fn fn) {
+        current = stage;
+        const size_t allocs = gAllocCount;
+        const size_t bytes = gAllocBytes;
+        const auto t0 = Clock::now();
+        fn();
+        run.millis[stage] = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        run.allocs[stage] = gAllocCount - allocs;
+        run.allocBytes[stage] = gAllocBytes - bytes;
+    }
+
+    AufgabenerstellungsgrammatikParser::ProgContext* parseTwoStage();
+
+    antlr4::ANTLRInputStream inputStream;
+    AufgabenerstellungsgrammatikLexer lexer;
+    NativeTokenSource nativeSource;
+    antlr4::CommonTokenStream tokens;
+    AufgabenerstellungsgrammatikParser parser;
+    DiagnosticListener listener;
+    std::shared_ptr<antlr4::BailErrorStrategy> bailStrategy;
+    std::shared_ptr<antlr4::DefaultErrorStrategy> defaultStrategy;
+    LexerKind lexerKind;
+    OutputFormat format;
+    Stage current = Read; // for the failure report
+};
+
+// Same strategy as Compiler::parseTwoStage
+AufgabenerstellungsgrammatikParser::ProgContext* Pipeline::parseTwoStage() {
+    auto* interp = parser.getInterpreter<antlr4::atn::ParserATNSimulator>();
+    interp->setPredictionMode(antlr4::atn::PredictionMode::SLL);
+    parser.setErrorHandler(bailStrategy);
+    parser.removeErrorListeners();
+
+    AufgabenerstellungsgrammatikParser::ProgContext* ctx = nullptr;
+    try {
+        ctx = parser.prog();
+    } catch (const antlr4::ParseCancellationException&) {
+        ctx = nullptr;
+    }
+
+    parser.addErrorListener(&listener);
+    parser.setErrorHandler(defaultStrategy);
+    interp->setPredictionMode(antlr4::atn::PredictionMode::LL);
+    if (ctx && parser.getNumberOfSyntaxErrors() == 0) return ctx;
+
+    parser.reset();
+    return parser.prog();
+}
+
+bool Pipeline::run(const Sample& s, Run& run, Failure& failure) {
+    auto fail = [&](std::string error) {
+        failure.input = s.input;
+        failure.stage = kStageNames[current];
+        failure.error = std::move(error);
+        return false;
+    };
+
+    try {
+        std::optional<SourceFile> file;
+        timed(Read, run, [&] { file.emplace(s.input); });
+        const std::string_view text = file->text();
+
+        timed(NativeIr, run, [&] {
+            ProgramIR ir;
+            NativeParser native(text, *ir.arenas.emplace_back(std::make_shared<Arena>()));
+            run.nativeRejected = !native.parseProgram(ir);
+        });
+
+        listener.messages.clear();
+        timed(Lex, run, [&] {
+            if (lexerKind == LexerKind::Native) {
+                nativeSource.reset(text, s.input, 1, &listener);
+                tokens.setTokenSource(&nativeSource);
+            } else {
+                inputStream.load(text.data(), text.size(), false);
+                inputStream.name = s.input;
+                lexer.setInputStream(&inputStream);
+                tokens.setTokenSource(&lexer);
+            }
+            parser.setTokenStream(&tokens);
+            tokens.fill();
+        });
+        if (!listener.messages.empty()) return fail(listener.messages.front());
+
+        AufgabenerstellungsgrammatikParser::ProgContext* ctx = nullptr;
+        timed(Parse, run, [&] { ctx = parseTwoStage(); });
+        if (parser.getNumberOfSyntaxErrors() > 0 || !listener.messages.empty()) {
+            return fail(listener.messages.empty() ? "Syntaxfehler" : listener.messages.front());
+        }
+
+        ProgramIR ir;
+        timed(IrBuild, run, [&] {
+            IRBuilder builder(text, &tokens, *ir.arenas.emplace_back(std::make_shared<Arena>()),
+                              lexerKind == LexerKind::Native);
+            builder.buildProgram(ctx, ir);
+        });
+
+        ProgramD prog;
+        timed(Convert, run, [&] { prog = convertProgram(std::move(ir)); });
+        run.tasks = prog.tasks.size();
+
+        std::string json;
+        timed(Json, run, [&] { json = domainToJson(prog); });
+        timed(Pretty, run, [&] { json = prettyJsonDomain(json); });
+        timed(Write, run, [&] { writeDomainOutput(prog, s.output, format); });
+    } catch (const std::exception& ex) {
+        return fail(ex.what());
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Inputs
+// ----------------------------------------------------------------------------
+
+// One task per piece, cut like --recover does (see splitTaskUnits), so a task
+// with a trailing comment or a missing ';' stays a sample of its own.
+std::vector<std::string> splitIntoTasks(std::string_view src) {
+    std::vector<TaskChunk> chunks;
+    splitTaskUnits(src, chunks);
+    std::vector<std::string> out;
+    out.reserve(chunks.size());
+    for (const TaskChunk& ch : chunks) out.emplace_back(src.substr(ch.begin, ch.end - ch.begin));
+    return out;
+}
+
+// The task mix of perf/gen_perf_inputs.ps1, `tasks` tasks in a row
+std::string makeSynthetic(size_t tasks) {
+    static const char* const kTemplates[] = {
+        "Aufgabe %zu(L\xC3\xBC" "ckentext): F\xC3\xBClle die L\xC3\xBC" "cken aus.\n"
+        "    CPL ist ein (tolles,2) Modul.\n"
+        "    Ein Vogel kann (fliegen,1).;\n",
+        "Aufgabe %zu(Zuordnung):\n"
+        "    Ordne (Hauptstadt) zu (Land)!(3) -Paris/Frankreich -Berlin/Deutschland -Amsterdam/Niederlande\n"
+        "    Ordne (Hauptstadt) zu (Land)! -Paris/Frankreich -Berlin/Deutschland -Amsterdam/Niederlande;\n",
+        "Testaufgabe %zu(RoF):\n"
+        "    Berlin ist die Haupstadt von Deutschland. -Richtig\n"
+        "    Paris ist die Haupstadt von England. -Falsch -> Paris ist die Haupstadt von Frankreich.\n"
+        "    Diese Aufgabe ist super schwierig und Richtig. -Richtig;\n",
+        "Sortieren %zu(Umordnung):\n"
+        "    Sortiere die Zahlen aufsteigend nach ihrer gr\xC3\xB6\xC3\x9F" "e.(2) -1 -2 -3\n"
+        "    Sortiere die Zahlen aufsteigend nach ihrer gr\xC3\xB6\xC3\x9F" "e. -1 -2 -3 -4 -5 -6 -7 -8;\n",
+        "Aufgabe %zu(Markierung): Markiere alle Autoren.\n"
+        "    (Stephen King)[1] ist ein Buchautor.;\n",
+        "Aufgabe %zu(Markierung): Markiere alle Rechtschreibfehler.\n"
+        "    Die Haupstadt von Deutschland ist (Baerlin)[Berlin,1].\n"
+        "    Ein Vogel kann (vliegen)[fliegen,2].;\n",
+        "Aufgabe %zu(Textkorrektur): Korrigiere die Rechtschreibfehler im Text.\n"
+        "    Die Haupstadt von Deutschland ist (Baerlin)[Berlin,1].\n"
+        "    Ein Vogel kann (vliegen)[fliegen,2].;\n",
+        "Aufgabe %zu(Auswahl):\n"
+        "    Wie viele Bits sind in einem Byte. -8 Bit(2) -4 Bit -1 Bit -16 Bit\n"
+        "    Welche St\xC3\xA4" "dte sind in Deutschland? -Berlin(1) -Minden(1) -Paris(-1) -London(-1);\n",
+    };
+    constexpr size_t kTemplateCount = sizeof(kTemplates) / sizeof(kTemplates[0]);
+
+    std::string out;
+    char buf[512];
+    for (size_t i = 0; i < tasks; ++i) {
+        const int n = std::snprintf(buf, sizeof(buf), kTemplates[i % kTemplateCount], i + 1);
+        out.append(buf, static_cast<size_t>(n));
+    }
+    return out;
+}
+
+void writeText(const fs::path& path, std::string_view text) {
+    std::ofstream os(path, std::ios::binary);
+    os.write(text.data(), static_cast<std::streamsize>(text.size()));
+    if (!os) throw std::runtime_error("Konnte Datei nicht schreiben: " + path.string());
+}
+
+struct BenchOptions {
+    std::vector<std::string> inputs; // expandInputs() specs
+    std::vector<size_t> synthetic;   // task counts of generated inputs
+    bool split = false;              // one sample per task (perf/fail_share.ps1)
+    int reps = 5;
+    std::string outDir;
+    std::string jsonPath; // empty = stdout
+    LexerKind lexer = LexerKind::Native;
+    OutputFormat format = OutputFormat::Json;
+};
+
+std::vector<Sample> prepareSamples(const BenchOptions& opts) {
+    const fs::path inDir = fs::path(opts.outDir) / "in";
+    fs::create_directories(inDir);
+    fs::create_directories(fs::path(opts.outDir) / "out");
+
+    std::vector<std::string> inputs;
+    for (const auto& input : expandInputs(opts.inputs)) {
+        if (!opts.split) {
+            inputs.push_back(input);
+            continue;
+        }
+        SourceFile file(input);
+        const auto tasks = splitIntoTasks(file.text());
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "_task_%03zu.txt", i + 1);
+            const fs::path path = inDir / (fs::path(input).stem().string() + name);
+            writeText(path, tasks[i]);
+            inputs.push_back(path.string());
+        }
+    }
+    for (size_t n : opts.synthetic) {
+        const fs::path path = inDir / ("synthetic_" + std::to_string(n) + ".txt");
+        writeText(path, makeSynthetic(n));
+        inputs.push_back(path.string());
+    }
+
+    const auto outputs = outputPathsFor(inputs, (fs::path(opts.outDir) / "out").string(),
+                                        outputExtension(opts.format));
+    std::vector<Sample> samples;
+    for (size_t i = 0; i < inputs.size(); ++i) samples.push_back({inputs[i], outputs[i]});
+    return samples;
+}
+
+// ----------------------------------------------------------------------------
+// Report
+// ----------------------------------------------------------------------------
+
+struct StageSummary {
+    double p50 = 0.0, p95 = 0.0, p99 = 0.0, mean = 0.0; // ms per run
+    double usPerTask = 0.0, allocsPerTask = 0.0, allocBytesPerTask = 0.0;
+};
+
+StageSummary summarize(const StageStats& st, size_t tasks) {
+    StageSummary out;
+    double sum = 0.0;
+    for (double ms : st.millis) sum += ms;
+    const double perTask = tasks ? 1.0 / static_cast<double>(tasks) : 0.0;
+    out.p50 = percentile(st.millis, 0.50);
+    out.p95 = percentile(st.millis, 0.95);
+    out.p99 = percentile(st.millis, 0.99);
+    out.mean = st.millis.empty() ? 0.0 : sum / static_cast<double>(st.millis.size());
+    out.usPerTask = sum * 1000.0 * perTask;
+    out.allocsPerTask = static_cast<double>(st.allocs) * perTask;
+    out.allocBytesPerTask = static_cast<double>(st.allocBytes) * perTask;
+    return out;
+}
+
+const char* formatName(OutputFormat format) {
+    switch (format) {
+    case OutputFormat::Json: return "json";
+    case OutputFormat::JsonCompact: return "json-compact";
+    case OutputFormat::Bin: return "bin";
+    }
+    return "";
+}
+
+std::string fmt(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.4f", v);
+    return buf;
+}
+
+void writeJson(JsonSink& out, const BenchOptions& opts, size_t samples, size_t runs, size_t tasks,
+               size_t nativeRejected, const std::vector<StageStats>& stages,
+               const std::vector<Failure>& failures) {
+    out << "{\"lexer\": ";
+    out.string(opts.lexer == LexerKind::Native ? "native" : "antlr");
+    out << ", \"format\": ";
+    out.string(formatName(opts.format));
+    out << ", \"split\": " << (opts.split ? "true" : "false") << ", \"reps\": " << opts.reps
+        << ", \"samples\": " << static_cast<int>(samples) << ", \"runs\": " << static_cast<int>(runs)
+        << ", \"tasks_per_rep\": " << static_cast<int>(tasks / static_cast<size_t>(opts.reps))
+        << ", \"native_fallbacks\": " << static_cast<int>(nativeRejected)
+        << ", \"failed\": " << static_cast<int>(failures.size()) << ", \"stages\": [";
+
+    for (int s = 0; s < kStageCount; ++s) {
+        const StageSummary sum = summarize(stages[s], tasks);
+        if (s) out << ", ";
+        out << "{\"name\": ";
+        out.string(kStageNames[s]);
+        out << ", \"p50_ms\": " << fmt(sum.p50) << ", \"p95_ms\": " << fmt(sum.p95)
+            << ", \"p99_ms\": " << fmt(sum.p99) << ", \"mean_ms\": " << fmt(sum.mean)
+            << ", \"us_per_task\": " << fmt(sum.usPerTask) << ", \"allocs_per_task\": " << fmt(sum.allocsPerTask)
+            << ", \"alloc_bytes_per_task\": " << fmt(sum.allocBytesPerTask) << "}";
+    }
+
+    out << "], \"failures\": [";
+    for (size_t i = 0; i < failures.size(); ++i) {
+        if (i) out << ", ";
+        out << "{\"input\": ";
+        out.string(failures[i].input);
+        out << ", \"stage\": ";
+        out.string(failures[i].stage);
+        out << ", \"error\": ";
+        out.string(failures[i].error);
+        out << "}";
+    }
+    out << "]}\n";
+    out.flush();
+}
+
+int usage(const char* exe) {
+    std::fprintf(stderr,
+                 "Usage: %s [--lexer=native|antlr] [--format=json|json-compact|bin] [--reps N] [--split]\n"
+                 "       [--synthetic <tasks>]... [--out <dir>] [--json <file>] [<input|dir|glob|@list>...]\n"
+                 "Without inputs: perf/examples.txt usage/input\n",
+                 exe);
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions opts;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (arg == "--lexer=native") opts.lexer = LexerKind::Native;
+            else if (arg == "--lexer=antlr") opts.lexer = LexerKind::Antlr;
+            else if (arg == "--format=json") opts.format = OutputFormat::Json;
+            else if (arg == "--format=json-compact") opts.format = OutputFormat::JsonCompact;
+            else if (arg == "--format=bin") opts.format = OutputFormat::Bin;
+            else if (arg == "--split") opts.split = true;
+            else if (arg == "--reps" && hasValue) opts.reps = std::stoi(argv[++i]);
+            else if (arg == "--synthetic" && hasValue) opts.synthetic.push_back(std::stoul(argv[++i]));
+            else if (arg == "--out" && hasValue) opts.outDir = argv[++i];
+            else if (arg == "--json" && hasValue) opts.jsonPath = argv[++i];
+            else if (arg.rfind("--", 0) == 0) return usage(argv[0]);
+            else opts.inputs.push_back(arg);
+        }
+    } catch (const std::exception&) {
+        return usage(argv[0]);
+    }
+    if (opts.reps < 1) return usage(argv[0]);
+    if (opts.inputs.empty() && opts.synthetic.empty()) opts.inputs = {"perf/examples.txt", "usage/input"};
+    if (opts.outDir.empty()) opts.outDir = (fs::temp_directory_path() / "aufgaben_dsl_bench").string();
+
+    std::vector<Sample> samples;
+    try {
+        samples = prepareSamples(opts);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "%s\n", ex.what());
+        return 1;
+    }
+    if (samples.empty()) {
+        std::fprintf(stderr, "Keine Eingaben gefunden.\n");
+        return 1;
+    }
+
+    Pipeline pipeline(opts.lexer, opts.format);
+    std::vector<StageStats> stages(kStageCount);
+    std::vector<Failure> failures;
+    size_t runs = 0;
+    size_t tasks = 0;
+    size_t nativeRejected = 0;
+
+    // rep 0 warms the DFA caches and is not recorded; failures are reported once
+    for (int rep = 0; rep <= opts.reps; ++rep) {
+        for (const Sample& s : samples) {
+            Run run;
+            Failure failure;
+            if (!pipeline.run(s, run, failure)) {
+                if (rep == 0) failures.push_back(std::move(failure));
+                continue;
+            }
+            if (rep == 0) {
+                nativeRejected += run.nativeRejected;
+                continue;
+            }
+            for (int st = 0; st < kStageCount; ++st) {
+                stages[st].millis.push_back(run.millis[st]);
+                stages[st].allocs += run.allocs[st];
+                stages[st].allocBytes += run.allocBytes[st];
+            }
+            tasks += run.tasks;
+            ++runs;
+        }
+    }
+
+    std::fprintf(stderr, "samples=%zu runs=%zu tasks/rep=%zu failed=%zu native_fallbacks=%zu\n", samples.size(),
+                 runs, tasks / static_cast<size_t>(opts.reps), failures.size(), nativeRejected);
+    std::fprintf(stderr, "%-15s %9s %9s %9s %11s %13s %15s\n", "stage", "p50 ms", "p95 ms", "p99 ms", "us/task",
+                 "allocs/task", "alloc B/task");
+    for (int s = 0; s < kStageCount; ++s) {
+        const StageSummary sum = summarize(stages[s], tasks);
+        std::fprintf(stderr, "%-15s %9.4f %9.4f %9.4f %11.2f %13.1f %15.1f\n", kStageNames[s], sum.p50, sum.p95,
+                     sum.p99, sum.usPerTask, sum.allocsPerTask, sum.allocBytesPerTask);
+    }
+    for (const Failure& f : failures) {
+        std::fprintf(stderr, "[fail] %s (%s): %s\n", f.input.c_str(), f.stage, f.error.c_str());
+    }
+
+    std::FILE* file = opts.jsonPath.empty() ? stdout : std::fopen(opts.jsonPath.c_str(), "wb");
+    if (!file) {
+        std::fprintf(stderr, "Konnte Datei nicht schreiben: %s\n", opts.jsonPath.c_str());
+        return 1;
+    }
+    try {
+        JsonSink sink(file, JsonStyle::Pretty);
+        writeJson(sink, opts, samples.size(), runs, tasks, nativeRejected, stages, failures);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "%s\n", ex.what());
+    }
+    if (file != stdout) std::fclose(file);
+    return runs > 0 ? 0 : 1; // failing samples are data (fail share), not an error
+}
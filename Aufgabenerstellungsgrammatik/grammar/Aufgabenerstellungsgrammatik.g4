@@ -3,6 +3,8 @@ grammar Aufgabenerstellungsgrammatik;
 prog:   tasks NEWLINE? EOF;
 tasks:  (task_definition NEWLINE)* task_definition ;
 task_definition:   endless_words task;
+/** Entry point for one task cut out at a ';' NEWLINE boundary (parallel compile) */
+task_unit:  task_definition EOF;
 
 /** Basic Non-Terminal */
 sentence: endless_words PUNCTUATION;
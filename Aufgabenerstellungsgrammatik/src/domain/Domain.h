@@ -4,7 +4,8 @@
 // ============================================================================
 #pragma once
 
-#include <string>
+#include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -12,38 +13,38 @@
 
 // Task wrappers (header + payload)
 struct RoFTaskD {
-    std::string header;
-    std::vector<TrueFalseTaskIR> lines;
+    IRString header;
+    IRVector<TrueFalseTaskIR> lines;
 };
 
 struct SortingTaskD {
-    std::string header;
-    std::vector<SortingLineIR> lines;
+    IRString header;
+    IRVector<SortingLineIR> lines;
 };
 
 struct MatchingTaskD {
-    std::string header;
-    std::vector<MatchingLineIR> lines;
+    IRString header;
+    IRVector<MatchingLineIR> lines;
 };
 
 struct MarkingTaskD {
-    std::string header;
+    IRString header;
     MarkingTaskIR task;
 };
 
 struct ClozeTaskD {
-    std::string header;
+    IRString header;
     ClozeTaskIR task;
 };
 
 struct CorrectionTaskD {
-    std::string header;
+    IRString header;
     CorrectionTaskIR task;
 };
 
 struct ChoiceTaskD {
-    std::string header;
-    std::vector<ChoiceLineIR> lines;
+    IRString header;
+    IRVector<ChoiceLineIR> lines;
 };
 
 using TaskD = std::variant<
@@ -57,19 +58,36 @@ using TaskD = std::variant<
 >;
 
 struct ProgramD {
+    // Declared before `tasks`, so the tasks are destroyed first: destroying
+    // an IRVector reads the arena memory it lives in.
+    Arenas arenas; // taken over from ProgramIR; keeps strings and vectors alive
     std::vector<TaskD> tasks;
+
+    ProgramD() = default;
+    ProgramD(const ProgramD&) = default;
+    ProgramD(ProgramD&&) = default;
+    ProgramD& operator=(const ProgramD&) = delete;
+
+    // Member-wise assignment would release the old arenas before the old tasks
+    ProgramD& operator=(ProgramD&& other) noexcept {
+        ProgramD old(std::move(*this)); // dies at return, tasks before arenas
+        arenas = std::move(other.arenas);
+        tasks = std::move(other.tasks);
+        return *this;
+    }
 };
 
-inline const char* taskKind(const TaskD& t) {
-    return std::visit([](const auto& x) -> const char* {
-        using T = std::decay_t<decltype(x)>;
-        if constexpr (std::is_same_v<T, RoFTaskD>) return "RoF";
-        if constexpr (std::is_same_v<T, SortingTaskD>) return "Umordnung";
-        if constexpr (std::is_same_v<T, MatchingTaskD>) return "Zuordnung";
-        if constexpr (std::is_same_v<T, MarkingTaskD>) return "Markierung";
-        if constexpr (std::is_same_v<T, ClozeTaskD>) return "Lueckentext";
-        if constexpr (std::is_same_v<T, CorrectionTaskD>) return "Textkorrektur";
-        if constexpr (std::is_same_v<T, ChoiceTaskD>) return "Auswahl";
-        return "Unknown";
-    }, t);
-}
+// TaskD alternatives are ordered like TaskKind, so the variant index is the kind
+template <TaskKind K>
+using TaskDFor = std::variant_alternative_t<static_cast<size_t>(K), TaskD>;
+
+static_assert(std::variant_size_v<TaskD> == kTaskKindCount, "one TaskD alternative per TaskKind");
+static_assert(std::is_same_v<TaskDFor<TaskKind::RoF>, RoFTaskD>);
+static_assert(std::is_same_v<TaskDFor<TaskKind::Sorting>, SortingTaskD>);
+static_assert(std::is_same_v<TaskDFor<TaskKind::Matching>, MatchingTaskD>);
+static_assert(std::is_same_v<TaskDFor<TaskKind::Marking>, MarkingTaskD>);
+static_assert(std::is_same_v<TaskDFor<TaskKind::Cloze>, ClozeTaskD>);
+static_assert(std::is_same_v<TaskDFor<TaskKind::Correction>, CorrectionTaskD>);
+static_assert(std::is_same_v<TaskDFor<TaskKind::Choice>, ChoiceTaskD>);
+
+inline TaskKind taskKind(const TaskD& t) { return static_cast<TaskKind>(t.index()); }
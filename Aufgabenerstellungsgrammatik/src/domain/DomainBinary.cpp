@@ -0,0 +1,525 @@
+// ============================================================================
+// File: src/domain/DomainBinary.cpp
+// ============================================================================
+#include "domain/DomainBinary.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+// -------------------------
+// Writer
+// -------------------------
+namespace {
+
+// fseek takes a long, which is 32-bit on Windows; offsets past 2 GiB need these
+int seekAbsolute(std::FILE* file, uint64_t at) {
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<__int64>(at), SEEK_SET);
+#else
+    return fseeko(file, static_cast<off_t>(at), SEEK_SET);
+#endif
+}
+
+// Appends little-endian fields. File mode: chunks of ~64 KiB are flushed with
+// fwrite (bounded memory). Memory mode: fields go straight into the target string.
+class BinWriter {
+public:
+    explicit BinWriter(std::FILE* f) : file(f), buf(&chunk) { chunk.reserve(kFlushAt + 4096); }
+    explicit BinWriter(std::string& out) : buf(&out) {}
+
+    void u8(uint8_t v) { buf->push_back(static_cast<char>(v)); maybeFlush(); }
+    void u32(uint32_t v) { le(v, 4); }
+    void i32(int32_t v) { le(static_cast<uint32_t>(v), 4); }
+    void u64(uint64_t v) { le(v, 8); }
+
+    void str(std::string_view s) {
+        if (s.size() > UINT32_MAX) throw std::runtime_error("string too long for binary output");
+        u32(static_cast<uint32_t>(s.size()));
+        buf->append(s.data(), s.size());
+        maybeFlush();
+    }
+
+    uint64_t position() const { return written + buf->size(); }
+
+    void flush() {
+        if (!file || chunk.empty()) return;
+        if (std::fwrite(chunk.data(), 1, chunk.size(), file) != chunk.size()) {
+            throw std::runtime_error("Could not write output file");
+        }
+        written += chunk.size();
+        chunk.clear();
+    }
+
+    // Overwrites already written bytes (offset table); call flush() first.
+    void patch(uint64_t at, const std::string& bytes) {
+        if (!file) {
+            std::memcpy(&(*buf)[static_cast<size_t>(at)], bytes.data(), bytes.size());
+            return;
+        }
+        if (seekAbsolute(file, at) != 0 ||
+            std::fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size() ||
+            std::fseek(file, 0, SEEK_END) != 0) {
+            throw std::runtime_error("Could not write output file");
+        }
+    }
+
+private:
+    static constexpr size_t kFlushAt = 64 * 1024;
+
+    void le(uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; ++i) buf->push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+        maybeFlush();
+    }
+    void maybeFlush() {
+        if (file && chunk.size() >= kFlushAt) flush();
+    }
+
+    std::FILE* file = nullptr;
+    std::string chunk;   // file mode buffer
+    std::string* buf;    // chunk, or the caller's string
+    uint64_t written = 0;
+};
+
+void putSentence(BinWriter& w, const SentenceIR& s) {
+    w.str(s.text);
+    w.u8(static_cast<uint8_t>(s.punctuation));
+}
+
+void putPoints(BinWriter& w, const TaskPointsIR& p) {
+    w.u8(static_cast<uint8_t>(p.scoringMode));
+    w.u8(p.pointsIfAllCorrect.has_value() ? 1 : 0);
+    w.i32(p.pointsIfAllCorrect.value_or(0));
+}
+
+template <class T, class Fn>
+void putVec(BinWriter& w, const IRVector<T>& v, Fn each) {
+    w.u32(static_cast<uint32_t>(v.size()));
+    for (const auto& x : v) each(x);
+}
+
+void putTask(BinWriter& w, const TaskD& t) {
+    w.u8(static_cast<uint8_t>(taskKind(t)));
+
+    std::visit([&](const auto& x) {
+        using T = std::decay_t<decltype(x)>;
+        w.str(x.header);
+
+        if constexpr (std::is_same_v<T, RoFTaskD>) {
+            putVec(w, x.lines, [&](const TrueFalseTaskIR& l) {
+                putSentence(w, l.question);
+                w.u8(l.answer.isTrue ? 1 : 0);
+                w.u8(l.answer.reason.has_value() ? 1 : 0);
+                if (l.answer.reason) putSentence(w, *l.answer.reason);
+            });
+        }
+        else if constexpr (std::is_same_v<T, SortingTaskD>) {
+            putVec(w, x.lines, [&](const SortingLineIR& l) {
+                putSentence(w, l.question);
+                putPoints(w, l.points);
+                putVec(w, l.items, [&](IRString s) { w.str(s); });
+            });
+        }
+        else if constexpr (std::is_same_v<T, MatchingTaskD>) {
+            putVec(w, x.lines, [&](const MatchingLineIR& l) {
+                w.str(l.question.prefix);
+                w.str(l.question.slotA);
+                w.str(l.question.middle);
+                w.str(l.question.slotB);
+                w.u8(static_cast<uint8_t>(l.question.punctuation));
+                putPoints(w, l.points);
+                putVec(w, l.pairs, [&](const MatchingItemIR& p) {
+                    w.str(p.left);
+                    w.str(p.right);
+                });
+            });
+        }
+        else if constexpr (std::is_same_v<T, MarkingTaskD>) {
+            putSentence(w, x.task.question);
+            putVec(w, x.task.sentences, [&](const MarkingSentenceIR& s) {
+                w.u8(static_cast<uint8_t>(s.punctuation));
+                putVec(w, s.parts, [&](const MarkingPartIR& p) {
+                    w.str(p.text);
+                    w.u8(p.mark.has_value() ? 1 : 0);
+                    if (p.mark) {
+                        w.str(p.mark->markedText);
+                        w.u8(p.mark->correction.has_value() ? 1 : 0);
+                        if (p.mark->correction) w.str(*p.mark->correction);
+                        w.i32(p.mark->points);
+                    }
+                });
+            });
+        }
+        else if constexpr (std::is_same_v<T, ClozeTaskD>) {
+            putSentence(w, x.task.question);
+            putVec(w, x.task.sentences, [&](const ClozeSentenceIR& s) {
+                w.u8(static_cast<uint8_t>(s.punctuation));
+                putVec(w, s.parts, [&](const ClozePartIR& p) {
+                    w.str(p.text);
+                    w.u8(p.blank.has_value() ? 1 : 0);
+                    if (p.blank) {
+                        w.str(p.blank->solution);
+                        w.i32(p.blank->points);
+                    }
+                });
+            });
+        }
+        else if constexpr (std::is_same_v<T, CorrectionTaskD>) {
+            putSentence(w, x.task.question);
+            putVec(w, x.task.sentences, [&](const CorrectionSentenceIR& s) {
+                w.u8(static_cast<uint8_t>(s.punctuation));
+                putVec(w, s.parts, [&](const CorrectionPartIR& p) {
+                    w.str(p.text);
+                    w.u8(p.corr.has_value() ? 1 : 0);
+                    if (p.corr) {
+                        w.str(p.corr->wrong);
+                        w.str(p.corr->correct);
+                        w.i32(p.corr->points);
+                    }
+                });
+            });
+        }
+        else if constexpr (std::is_same_v<T, ChoiceTaskD>) {
+            putVec(w, x.lines, [&](const ChoiceLineIR& l) {
+                putSentence(w, l.question);
+                putVec(w, l.options, [&](const ChoiceOptionIR& o) {
+                    w.str(o.text);
+                    w.i32(o.points);
+                    w.u8(o.isCorrect ? 1 : 0);
+                });
+            });
+        }
+    }, t);
+}
+
+void putProgram(BinWriter& w, const ProgramD& prog) {
+    const uint32_t count = static_cast<uint32_t>(prog.tasks.size());
+    w.u8('A'); w.u8('U'); w.u8('F'); w.u8('B');
+    w.u32(kDomainBinaryVersion);
+    w.u32(count);
+    w.u32(0);
+
+    const uint64_t tableAt = w.position();
+    for (uint32_t i = 0; i < count; ++i) w.u64(0); // patched below
+
+    std::string table;
+    table.reserve(size_t(count) * 8);
+    for (const auto& t : prog.tasks) {
+        const uint64_t at = w.position();
+        for (int b = 0; b < 8; ++b) table.push_back(static_cast<char>((at >> (8 * b)) & 0xFF));
+        putTask(w, t);
+    }
+
+    w.flush();
+    if (count > 0) w.patch(tableAt, table);
+}
+
+} // namespace
+
+std::string domainToBinary(const ProgramD& prog) {
+    std::string out;
+    BinWriter w(out);
+    putProgram(w, prog);
+    return out;
+}
+
+void writeDomainBinaryFile(const ProgramD& prog, const std::string& path) {
+    namespace fs = std::filesystem;
+
+    fs::path p(path);
+    if (p.has_parent_path()) fs::create_directories(p.parent_path());
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) throw std::runtime_error("Could not open output file: " + path);
+
+    try {
+        BinWriter w(f);
+        putProgram(w, prog);
+    } catch (...) {
+        std::fclose(f);
+        throw;
+    }
+    if (std::fclose(f) != 0) throw std::runtime_error("Could not write output file: " + path);
+}
+
+// -------------------------
+// Reader
+// -------------------------
+namespace {
+
+class BinReader {
+public:
+    BinReader(std::string_view d, Arena& p) : data(d), arena(p) {}
+
+    uint8_t u8() {
+        need(1);
+        return static_cast<uint8_t>(data[pos++]);
+    }
+    uint32_t u32() { return static_cast<uint32_t>(le(4)); }
+    int32_t i32() { return static_cast<int32_t>(static_cast<uint32_t>(le(4))); }
+    uint64_t u64() { return le(8); }
+
+    // copied into the program's arena (the input buffer may go away)
+    IRString str() {
+        const uint32_t n = u32();
+        need(n);
+        const IRString s = arena.intern(data.substr(pos, n));
+        pos += n;
+        return s;
+    }
+
+    // element count, sanity-checked against the remaining bytes
+    uint32_t count() {
+        const uint32_t n = u32();
+        if (n > data.size() - pos) fail();
+        return n;
+    }
+
+    void seek(uint64_t at) {
+        if (at > data.size()) fail();
+        pos = static_cast<size_t>(at);
+    }
+
+    [[noreturn]] void fail() const {
+        throw std::runtime_error("Truncated or corrupt binary domain data at byte " + std::to_string(pos));
+    }
+
+private:
+    void need(size_t n) const {
+        if (n > data.size() - pos) fail();
+    }
+    uint64_t le(int bytes) {
+        need(static_cast<size_t>(bytes));
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) v |= uint64_t(static_cast<uint8_t>(data[pos + i])) << (8 * i);
+        pos += static_cast<size_t>(bytes);
+        return v;
+    }
+
+    std::string_view data;
+    Arena& arena;
+    size_t pos = 0;
+};
+
+SentenceIR getSentence(BinReader& r) {
+    SentenceIR s;
+    s.text = r.str();
+    s.punctuation = static_cast<char>(r.u8());
+    return s;
+}
+
+TaskPointsIR getPoints(BinReader& r) {
+    TaskPointsIR p;
+    const uint8_t mode = r.u8();
+    if (mode > static_cast<uint8_t>(ScoringModeIR::PartialInOrder)) r.fail();
+    p.scoringMode = static_cast<ScoringModeIR>(mode);
+    const bool has = r.u8() != 0;
+    const int32_t v = r.i32();
+    if (has) p.pointsIfAllCorrect = v;
+    return p;
+}
+
+template <class T, class Fn>
+void getVec(BinReader& r, IRVector<T>& out, Fn each) {
+    const uint32_t n = r.count();
+    out.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) out.push_back(each());
+}
+
+TaskD getTask(BinReader& r) {
+    const uint8_t kind = r.u8();
+    const IRString header = r.str();
+
+    switch (static_cast<TaskKind>(kind)) {
+    case TaskKind::RoF: {
+        RoFTaskD t{header, {}};
+        getVec(r, t.lines, [&] {
+            TrueFalseTaskIR l;
+            l.question = getSentence(r);
+            l.answer.isTrue = r.u8() != 0;
+            if (r.u8()) l.answer.reason = getSentence(r);
+            return l;
+        });
+        return t;
+    }
+    case TaskKind::Sorting: {
+        SortingTaskD t{header, {}};
+        getVec(r, t.lines, [&] {
+            SortingLineIR l;
+            l.question = getSentence(r);
+            l.points = getPoints(r);
+            getVec(r, l.items, [&] { return r.str(); });
+            return l;
+        });
+        return t;
+    }
+    case TaskKind::Matching: {
+        MatchingTaskD t{header, {}};
+        getVec(r, t.lines, [&] {
+            MatchingLineIR l;
+            l.question.prefix = r.str();
+            l.question.slotA = r.str();
+            l.question.middle = r.str();
+            l.question.slotB = r.str();
+            l.question.punctuation = static_cast<char>(r.u8());
+            l.points = getPoints(r);
+            getVec(r, l.pairs, [&] {
+                MatchingItemIR p;
+                p.left = r.str();
+                p.right = r.str();
+                return p;
+            });
+            return l;
+        });
+        return t;
+    }
+    case TaskKind::Marking: {
+        MarkingTaskD t{header, {}};
+        t.task.question = getSentence(r);
+        getVec(r, t.task.sentences, [&] {
+            MarkingSentenceIR s;
+            s.punctuation = static_cast<char>(r.u8());
+            getVec(r, s.parts, [&] {
+                MarkingPartIR p;
+                p.text = r.str();
+                if (r.u8()) {
+                    MarkedSpanIR m;
+                    m.markedText = r.str();
+                    if (r.u8()) m.correction = r.str();
+                    m.points = r.i32();
+                    p.mark = std::move(m);
+                }
+                return p;
+            });
+            return s;
+        });
+        return t;
+    }
+    case TaskKind::Cloze: {
+        ClozeTaskD t{header, {}};
+        t.task.question = getSentence(r);
+        getVec(r, t.task.sentences, [&] {
+            ClozeSentenceIR s;
+            s.punctuation = static_cast<char>(r.u8());
+            getVec(r, s.parts, [&] {
+                ClozePartIR p;
+                p.text = r.str();
+                if (r.u8()) {
+                    ClozeBlankIR b;
+                    b.solution = r.str();
+                    b.points = r.i32();
+                    p.blank = std::move(b);
+                }
+                return p;
+            });
+            return s;
+        });
+        return t;
+    }
+    case TaskKind::Correction: {
+        CorrectionTaskD t{header, {}};
+        t.task.question = getSentence(r);
+        getVec(r, t.task.sentences, [&] {
+            CorrectionSentenceIR s;
+            s.punctuation = static_cast<char>(r.u8());
+            getVec(r, s.parts, [&] {
+                CorrectionPartIR p;
+                p.text = r.str();
+                if (r.u8()) {
+                    CorrectionSpanIR c;
+                    c.wrong = r.str();
+                    c.correct = r.str();
+                    c.points = r.i32();
+                    p.corr = std::move(c);
+                }
+                return p;
+            });
+            return s;
+        });
+        return t;
+    }
+    case TaskKind::Choice: {
+        ChoiceTaskD t{header, {}};
+        getVec(r, t.lines, [&] {
+            ChoiceLineIR l;
+            l.question = getSentence(r);
+            getVec(r, l.options, [&] {
+                ChoiceOptionIR o;
+                o.text = r.str();
+                o.points = r.i32();
+                o.isCorrect = r.u8() != 0;
+                return o;
+            });
+            return l;
+        });
+        return t;
+    }
+    default:
+        throw std::runtime_error("Unknown task kind in binary domain data: " + std::to_string(kind));
+    }
+}
+
+} // namespace
+
+static_assert(kTaskKindCount == 7, "DomainBinary: a new TaskKind needs a payload layout and a version bump");
+
+ProgramD domainFromBinary(std::string_view data) {
+    if (data.size() < 16 || data.substr(0, 4) != "AUFB") {
+        throw std::runtime_error("Not a binary domain file (missing AUFB header)");
+    }
+
+    ProgramD prog;
+    prog.arenas.push_back(std::make_shared<Arena>());
+    BinReader r(data, *prog.arenas.back());
+    ArenaScope scope(*prog.arenas.back());
+    r.seek(4);
+    const uint32_t version = r.u32();
+    if (version < kDomainBinaryMinVersion || version > kDomainBinaryVersion) {
+        throw std::runtime_error("Unsupported binary domain version: " + std::to_string(version));
+    }
+    const uint32_t count = r.u32();
+    r.u32(); // reserved
+
+    std::vector<uint64_t> offsets(count > (data.size() - 16) / 8 ? 0 : count);
+    if (offsets.size() != count) r.fail();
+    for (auto& o : offsets) o = r.u64();
+
+    prog.tasks.reserve(count);
+    for (uint64_t at : offsets) {
+        r.seek(at);
+        prog.tasks.push_back(getTask(r));
+    }
+    return prog;
+}
+
+std::string taskToBinary(const TaskD& task) {
+    std::string out;
+    BinWriter w(out);
+    putTask(w, task);
+    return out;
+}
+
+TaskD taskFromBinary(std::string_view record, Arena& arena) {
+    BinReader r(record, arena);
+    ArenaScope scope(arena);
+    return getTask(r);
+}
+
+ProgramD readDomainBinaryFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Could not open input file: " + path);
+
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    return domainFromBinary(buffer.str());
+}
@@ -0,0 +1,52 @@
+// ============================================================================
+// File: src/domain/DomainBinary.h
+// Versioned, length-prefixed binary form of ProgramD (alternative to JSON)
+// ============================================================================
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "domain/Domain.h"
+
+// Layout (little endian):
+//   "AUFB"  u32 version  u32 taskCount  u32 reserved(0)
+//   u64 taskOffset[taskCount]            absolute offset of every task record
+//   task records:  u8 kind (TaskKind = TaskD index)  str header  payload
+//
+//   str       = u32 length + bytes (UTF-8, no terminator)
+//   sentence  = str text, u8 punctuation
+//   points    = u8 scoringMode (0 Partial, 1 AllOrNothing, 2 PartialInOrder), u8 hasPoints,
+//               i32 pointsIfAllCorrect
+//   vec<T>    = u32 count + count * T
+//   optional  = u8 present + [T]
+//
+//   RoF        vec< sentence question, u8 isTrue, optional<sentence> reason >
+//   Umordnung  vec< sentence, points, vec<str> items >
+//   Zuordnung  vec< str prefix, str slotA, str middle, str slotB, u8 punct, points,
+//                   vec< str left, str right > >
+//   Markierung sentence, vec< u8 punct, vec< str text,
+//                   optional< str markedText, optional<str> correction, i32 points > > >
+//   Lückentext sentence, vec< u8 punct, vec< str text, optional< str solution, i32 points > > >
+//   Textkorr.  sentence, vec< u8 punct, vec< str text,
+//                   optional< str wrong, str correct, i32 points > > >
+//   Auswahl    vec< sentence, vec< str text, i32 points, u8 isCorrect > >
+//
+// The offset table lets a reader jump to single tasks; strings are copied out
+// with one memcpy each, there is no tokenizing.
+// Version 2 added scoringMode 2; version 1 files are read unchanged.
+constexpr uint32_t kDomainBinaryVersion = 2;
+constexpr uint32_t kDomainBinaryMinVersion = 1;
+
+std::string domainToBinary(const ProgramD& prog);
+void writeDomainBinaryFile(const ProgramD& prog, const std::string& path);
+
+// Throws std::runtime_error on a wrong magic/version or truncated data.
+ProgramD domainFromBinary(std::string_view data);
+ProgramD readDomainBinaryFile(const std::string& path);
+
+// One task record (u8 kind, str header, payload) without the file header;
+// strings and vectors of the decoded task live in `arena` (see TaskCache).
+std::string taskToBinary(const TaskD& task);
+TaskD taskFromBinary(std::string_view record, Arena& arena);
@@ -3,50 +3,62 @@
 // ============================================================================
 #include "domain/DomainConvert.h"
 
-TaskD convertTask(const TaskIR& ir) {
-    if (ir.type == "RoF") {
-        RoFTaskD t{ir.header, ir.rof};
-        return t;
-    }
-    if (ir.type == "Umordnung") {
-        SortingTaskD t{ir.header, ir.sorting};
-        return t;
-    }
-    if (ir.type == "Zuordnung") {
-        MatchingTaskD t{ir.header, ir.matching};
-        return t;
-    }
-    if (ir.type == "Markierung") {
+#include <string>
+#include <utility>
+
+// Consuming conversion: headers, line vectors and optional payloads are moved
+// out of `ir`, which is left in a valid but unspecified state.
+TaskD convertTask(TaskIR&& ir) {
+    switch (ir.kind) {
+    case TaskKind::RoF:
+        return RoFTaskD{std::move(ir.header), std::move(ir.rof)};
+    case TaskKind::Sorting:
+        return SortingTaskD{std::move(ir.header), std::move(ir.sorting)};
+    case TaskKind::Matching:
+        return MatchingTaskD{std::move(ir.header), std::move(ir.matching)};
+    case TaskKind::Marking:
         if (!ir.marking) throw std::runtime_error("Markierung task missing payload");
-        MarkingTaskD t{ir.header, *ir.marking};
-        return t;
-    }
-    if (ir.type == "Lückentext" || ir.type == "Lueckentext") {
+        return MarkingTaskD{std::move(ir.header), std::move(*ir.marking)};
+    case TaskKind::Cloze:
         if (!ir.cloze) throw std::runtime_error("Lueckentext task missing payload");
-        ClozeTaskD t{ir.header, *ir.cloze};
-        return t;
-    }
-    if (ir.type == "Textkorrektur") {
+        return ClozeTaskD{std::move(ir.header), std::move(*ir.cloze)};
+    case TaskKind::Correction:
         if (!ir.correction) throw std::runtime_error("Textkorrektur task missing payload");
-        CorrectionTaskD t{ir.header, *ir.correction};
-        return t;
-    }
-    if (ir.type == "Auswahl") {
-        ChoiceTaskD t{ir.header, ir.choice};
-        return t;
+        return CorrectionTaskD{std::move(ir.header), std::move(*ir.correction)};
+    case TaskKind::Choice:
+        return ChoiceTaskD{std::move(ir.header), std::move(ir.choice)};
+    case TaskKind::Unknown:
+        break;
     }
 
-    throw std::runtime_error("Unknown task type in convertTask(): " + ir.type);
+    throw std::runtime_error("Unknown task type in convertTask(): " + std::string(taskKindName(ir.kind)));
+}
+
+ProgramD convertProgram(ProgramIR&& ir) {
+    ProgramD out;
+    out.tasks.reserve(ir.tasks.size());
+    for (auto& t : ir.tasks) {
+        if (t.kind == TaskKind::Unknown) {
+            throw std::runtime_error("Cannot convert task with type=Unknown (header=" + std::string(t.header) + ")");
+        }
+        out.tasks.push_back(convertTask(std::move(t)));
+    }
+    // only moved-from shells are left; release them before the caller serializes
+    ir.tasks.clear();
+    ir.tasks.shrink_to_fit();
+    out.arenas = std::move(ir.arenas);
+    return out;
 }
 
 ProgramD convertProgram(const ProgramIR& ir) {
     ProgramD out;
     out.tasks.reserve(ir.tasks.size());
     for (const auto& t : ir.tasks) {
-        if (t.type == "Unknown") {
-            throw std::runtime_error("Cannot convert task with type=Unknown (header=" + t.header + ")");
+        if (t.kind == TaskKind::Unknown) {
+            throw std::runtime_error("Cannot convert task with type=Unknown (header=" + std::string(t.header) + ")");
         }
-        out.tasks.push_back(convertTask(t));
+        out.tasks.push_back(convertTask(TaskIR(t)));
     }
+    out.arenas = ir.arenas; // shared, the views point into the same storage
     return out;
 }
@@ -7,5 +7,13 @@
 #include "ir/IR.h"
 #include "domain/Domain.h"
 
-TaskD convertTask(const TaskIR& ir);
+// Strings in the IR and the domain model are views into the program's arenas,
+// so a converted task is only valid while those arenas live.
+// convertTask moves the line vectors out of `ir`; the caller keeps the arena
+// the task was built in alive next to the TaskD.
+TaskD convertTask(TaskIR&& ir);
+
+// Consuming overload (hot path): moves the tasks and takes over `ir.arenas`.
+ProgramD convertProgram(ProgramIR&& ir);
+// Leaves the IR untouched: copies the tasks, shares `ir.arenas` with the result.
 ProgramD convertProgram(const ProgramIR& ir);
@@ -4,8 +4,8 @@
 // ============================================================================
 #include "domain/DomainJson.h"
 
+#include <cstdio>
 #include <filesystem>
-#include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <type_traits>
@@ -13,37 +13,21 @@
 // -------------------------
 // JSON helpers
 // -------------------------
-static void escapeJson(const std::string& in, std::ostream& os) {
-    for (char c : in) {
-        switch (c) {
-        case '\"': os << "\\\""; break;
-        case '\\': os << "\\\\"; break;
-        case '\n': os << "\\n";  break;
-        case '\r': os << "\\r";  break;
-        case '\t': os << "\\t";  break;
-        default:   os << c;      break;
-        }
-    }
+static void writeStr(JsonSink& os, std::string_view s) {
+    os.string(s);
 }
 
-static void writeStr(std::ostream& os, const std::string& s) {
-    os << "\"";
-    escapeJson(s, os);
-    os << "\"";
-}
-
-static void writeStrField(std::ostream& os, const char* key, const std::string& val) {
+static void writeStrField(JsonSink& os, const char* key, IRString val) {
     os << "\"" << key << "\": ";
     writeStr(os, val);
 }
 
-static void writeCharField(std::ostream& os, const char* key, char c) {
+static void writeCharField(JsonSink& os, const char* key, char c) {
     os << "\"" << key << "\": ";
-    std::string s(1, c);
-    writeStr(os, s);
+    writeStr(os, std::string_view(&c, 1));
 }
 
-static void writeSentence(std::ostream& os, const SentenceIR& s) {
+static void writeSentence(JsonSink& os, const SentenceIR& s) {
     os << "{ ";
     writeStrField(os, "text", s.text);
     os << ", ";
@@ -51,10 +35,11 @@ static void writeSentence(std::ostream& os, const SentenceIR& s) {
     os << " }";
 }
 
-static void writeTaskPoints(std::ostream& os, const TaskPointsIR& p) {
+static void writeTaskPoints(JsonSink& os, const TaskPointsIR& p) {
     os << "{ ";
     os << "\"scoringMode\": ";
     if (p.scoringMode == ScoringModeIR::AllOrNothing) writeStr(os, "AllOrNothing");
+    else if (p.scoringMode == ScoringModeIR::PartialInOrder) writeStr(os, "PartialInOrder");
     else writeStr(os, "PartialPerCorrect");
     if (p.pointsIfAllCorrect.has_value()) {
         os << ", \"pointsIfAllCorrect\": " << *p.pointsIfAllCorrect;
@@ -63,7 +48,7 @@ static void writeTaskPoints(std::ostream& os, const TaskPointsIR& p) {
 }
 
 // ---------- RoF ----------
-static void writeAnswer(std::ostream& os, const AnswerIR& a) {
+static void writeAnswer(JsonSink& os, const AnswerIR& a) {
     os << "{ \"isTrue\": " << (a.isTrue ? "true" : "false");
     if (a.reason.has_value()) {
         os << ", \"reason\": ";
@@ -72,7 +57,7 @@ static void writeAnswer(std::ostream& os, const AnswerIR& a) {
     os << " }";
 }
 
-static void writeRoFLine(std::ostream& os, const TrueFalseTaskIR& line) {
+static void writeRoFLine(JsonSink& os, const TrueFalseTaskIR& line) {
     os << "{ \"question\": ";
     writeSentence(os, line.question);
     os << ", \"answer\": ";
@@ -81,7 +66,7 @@ static void writeRoFLine(std::ostream& os, const TrueFalseTaskIR& line) {
 }
 
 // ---------- Sorting ----------
-static void writeSortingLine(std::ostream& os, const SortingLineIR& line) {
+static void writeSortingLine(JsonSink& os, const SortingLineIR& line) {
     os << "{ \"question\": ";
     writeSentence(os, line.question);
     os << ", \"points\": ";
@@ -95,7 +80,7 @@ static void writeSortingLine(std::ostream& os, const SortingLineIR& line) {
 }
 
 // ---------- Matching ----------
-static void writeMatchingQuestion(std::ostream& os, const MatchingQuestionIR& q) {
+static void writeMatchingQuestion(JsonSink& os, const MatchingQuestionIR& q) {
     os << "{ ";
     writeStrField(os, "prefix", q.prefix);
     os << ", ";
@@ -109,7 +94,7 @@ static void writeMatchingQuestion(std::ostream& os, const MatchingQuestionIR& q)
     os << " }";
 }
 
-static void writeMatchingLine(std::ostream& os, const MatchingLineIR& line) {
+static void writeMatchingLine(JsonSink& os, const MatchingLineIR& line) {
     os << "{ \"question\": ";
     writeMatchingQuestion(os, line.question);
     os << ", \"points\": ";
@@ -127,10 +112,9 @@ static void writeMatchingLine(std::ostream& os, const MatchingLineIR& line) {
 }
 
 // ---------- Cloze ----------
-static void writeClozeSentence(std::ostream& os, const ClozeSentenceIR& s) {
+static void writeClozeSentence(JsonSink& os, const ClozeSentenceIR& s) {
     os << "{ \"punctuation\": ";
-    std::string p(1, s.punctuation);
-    writeStr(os, p);
+    writeStr(os, std::string_view(&s.punctuation, 1));
     os << ", \"parts\": [";
     for (size_t i = 0; i < s.parts.size(); ++i) {
         const auto& part = s.parts[i];
@@ -153,7 +137,7 @@ static void writeClozeSentence(std::ostream& os, const ClozeSentenceIR& s) {
     os << "] }";
 }
 
-static void writeClozeTask(std::ostream& os, const ClozeTaskIR& t) {
+static void writeClozeTask(JsonSink& os, const ClozeTaskIR& t) {
     os << "{ \"question\": ";
     writeSentence(os, t.question);
     os << ", \"sentences\": [";
@@ -165,10 +149,9 @@ static void writeClozeTask(std::ostream& os, const ClozeTaskIR& t) {
 }
 
 // ---------- Marking ----------
-static void writeMarkingSentence(std::ostream& os, const MarkingSentenceIR& s) {
+static void writeMarkingSentence(JsonSink& os, const MarkingSentenceIR& s) {
     os << "{ \"punctuation\": ";
-    std::string p(1, s.punctuation);
-    writeStr(os, p);
+    writeStr(os, std::string_view(&s.punctuation, 1));
     os << ", \"parts\": [";
     for (size_t i = 0; i < s.parts.size(); ++i) {
         const auto& part = s.parts[i];
@@ -195,7 +178,7 @@ static void writeMarkingSentence(std::ostream& os, const MarkingSentenceIR& s) {
     os << "] }";
 }
 
-static void writeMarkingTask(std::ostream& os, const MarkingTaskIR& t) {
+static void writeMarkingTask(JsonSink& os, const MarkingTaskIR& t) {
     os << "{ \"question\": ";
     writeSentence(os, t.question);
     os << ", \"sentences\": [";
@@ -207,10 +190,9 @@ static void writeMarkingTask(std::ostream& os, const MarkingTaskIR& t) {
 }
 
 // ---------- Correction ----------
-static void writeCorrectionSentence(std::ostream& os, const CorrectionSentenceIR& s) {
+static void writeCorrectionSentence(JsonSink& os, const CorrectionSentenceIR& s) {
     os << "{ \"punctuation\": ";
-    std::string p(1, s.punctuation);
-    writeStr(os, p);
+    writeStr(os, std::string_view(&s.punctuation, 1));
     os << ", \"parts\": [";
     for (size_t i = 0; i < s.parts.size(); ++i) {
         const auto& part = s.parts[i];
@@ -235,7 +217,7 @@ static void writeCorrectionSentence(std::ostream& os, const CorrectionSentenceIR
     os << "] }";
 }
 
-static void writeCorrectionTask(std::ostream& os, const CorrectionTaskIR& t) {
+static void writeCorrectionTask(JsonSink& os, const CorrectionTaskIR& t) {
     os << "{ \"question\": ";
     writeSentence(os, t.question);
     os << ", \"sentences\": [";
@@ -247,7 +229,7 @@ static void writeCorrectionTask(std::ostream& os, const CorrectionTaskIR& t) {
 }
 
 // ---------- Choice ----------
-static void writeChoiceOption(std::ostream& os, const ChoiceOptionIR& o) {
+static void writeChoiceOption(JsonSink& os, const ChoiceOptionIR& o) {
     os << "{ ";
     writeStrField(os, "text", o.text);
     os << ", \"points\": " << o.points;
@@ -255,7 +237,7 @@ static void writeChoiceOption(std::ostream& os, const ChoiceOptionIR& o) {
     os << " }";
 }
 
-static void writeChoiceLine(std::ostream& os, const ChoiceLineIR& line) {
+static void writeChoiceLine(JsonSink& os, const ChoiceLineIR& line) {
     os << "{ \"question\": ";
     writeSentence(os, line.question);
     os << ", \"options\": [";
@@ -266,7 +248,7 @@ static void writeChoiceLine(std::ostream& os, const ChoiceLineIR& line) {
     os << "] }";
 }
 
-static void writeChoiceTask(std::ostream& os, const std::vector<ChoiceLineIR>& lines) {
+static void writeChoiceTask(JsonSink& os, const IRVector<ChoiceLineIR>& lines) {
     os << "{ \"lines\": [";
     for (size_t i = 0; i < lines.size(); ++i) {
         writeChoiceLine(os, lines[i]);
@@ -278,13 +260,13 @@ static void writeChoiceTask(std::ostream& os, const std::vector<ChoiceLineIR>& l
 // -------------------------
 // Program / Task dispatch
 // -------------------------
-static void writeTask(std::ostream& os, const TaskD& t) {
+static void writeTask(JsonSink& os, const TaskD& t) {
     std::visit([&](const auto& x) {
         using T = std::decay_t<decltype(x)>;
 
         os << "{ ";
         os << "\"type\": ";
-        writeStr(os, taskKind(t));
+        writeStr(os, taskKindName(taskKind(t)));
         os << ", ";
         writeStrField(os, "header", x.header);
 
@@ -333,17 +315,25 @@ static void writeTask(std::ostream& os, const TaskD& t) {
     }, t);
 }
 
-std::string domainToJson(const ProgramD& prog) {
-    std::ostringstream os;
+static void writeProgram(JsonSink& os, const ProgramD& prog) {
     os << "{ \"type\": \"Program\", \"tasks\": [";
     for (size_t i = 0; i < prog.tasks.size(); ++i) {
         writeTask(os, prog.tasks[i]);
         if (i + 1 < prog.tasks.size()) os << ", ";
     }
     os << "] }";
-    return os.str();
 }
 
+std::string domainToJson(const ProgramD& prog, JsonStyle style) {
+    std::string out;
+    JsonSink sink(out, style);
+    writeProgram(sink, prog);
+    sink.flush();
+    return out;
+}
+
+// Reference formatter (second pass over compact JSON); JsonStyle::Pretty
+// produces the same bytes in a single pass.
 std::string prettyJsonDomain(const std::string& src) {
     std::ostringstream out;
     int indent = 0;
@@ -377,15 +367,23 @@ std::string prettyJsonDomain(const std::string& src) {
     return out.str();
 }
 
-void writeDomainToFile(const ProgramD& prog, const std::string& path) {
+void writeDomainToFile(const ProgramD& prog, const std::string& path, JsonStyle style) {
     namespace fs = std::filesystem;
 
     fs::path p(path);
     if (p.has_parent_path()) fs::create_directories(p.parent_path());
 
-    std::ofstream out(path);
-    if (!out) throw std::runtime_error("Could not open output file: " + path);
-
-    out << prettyJsonDomain(domainToJson(prog));
+    // text mode like the former std::ofstream (same line endings on Windows)
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) throw std::runtime_error("Could not open output file: " + path);
+
+    try {
+        JsonSink sink(f, style);
+        writeProgram(sink, prog);
+        sink.flush();
+    } catch (...) {
+        std::fclose(f);
+        throw;
+    }
+    if (std::fclose(f) != 0) throw std::runtime_error("Could not write output file: " + path);
 }
-
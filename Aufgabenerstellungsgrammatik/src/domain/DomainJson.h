@@ -5,7 +5,11 @@
 
 #include <string>
 #include "domain/Domain.h"
+#include "domain/JsonSink.h"
 
-std::string domainToJson(const ProgramD& prog);
+std::string domainToJson(const ProgramD& prog, JsonStyle style = JsonStyle::Compact);
 std::string prettyJsonDomain(const std::string& src);
-void writeDomainToFile(const ProgramD& prog, const std::string& path);
+
+// Streams the JSON straight to the file through a fixed-size buffer
+void writeDomainToFile(const ProgramD& prog, const std::string& path,
+                       JsonStyle style = JsonStyle::Pretty);
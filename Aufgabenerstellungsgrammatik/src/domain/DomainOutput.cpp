@@ -0,0 +1,28 @@
+// ============================================================================
+// File: src/domain/DomainOutput.cpp
+// ============================================================================
+#include "domain/DomainOutput.h"
+
+#include "domain/DomainBinary.h"
+#include "domain/DomainJson.h"
+
+const char* outputExtension(OutputFormat format) {
+    return format == OutputFormat::Bin ? ".bin" : ".json";
+}
+
+std::string renderDomainOutput(const ProgramD& prog, OutputFormat format) {
+    switch (format) {
+    case OutputFormat::JsonCompact: return domainToJson(prog, JsonStyle::Compact);
+    case OutputFormat::Bin:         return domainToBinary(prog);
+    case OutputFormat::Json:        break;
+    }
+    return domainToJson(prog, JsonStyle::Pretty);
+}
+
+void writeDomainOutput(const ProgramD& prog, const std::string& path, OutputFormat format) {
+    switch (format) {
+    case OutputFormat::Json:        writeDomainToFile(prog, path, JsonStyle::Pretty); break;
+    case OutputFormat::JsonCompact: writeDomainToFile(prog, path, JsonStyle::Compact); break;
+    case OutputFormat::Bin:         writeDomainBinaryFile(prog, path); break;
+    }
+}
@@ -0,0 +1,23 @@
+// ============================================================================
+// File: src/domain/DomainOutput.h
+// Output format selection (--format=json|json-compact|bin)
+// ============================================================================
+#pragma once
+
+#include <string>
+
+#include "domain/Domain.h"
+
+enum class OutputFormat {
+    Json,        // pretty JSON (default, prettyJsonDomain layout)
+    JsonCompact, // single-line JSON (domainToJson layout)
+    Bin          // DomainBinary.h
+};
+
+// ".json" or ".bin" (batch output names)
+const char* outputExtension(OutputFormat format);
+
+// Same layout as writeDomainOutput(), in memory (--serve responses)
+std::string renderDomainOutput(const ProgramD& prog, OutputFormat format);
+
+void writeDomainOutput(const ProgramD& prog, const std::string& path, OutputFormat format);
@@ -0,0 +1,103 @@
+// ============================================================================
+// File: src/domain/JsonEscape.cpp
+// ============================================================================
+#include "domain/JsonEscape.h"
+
+#if defined(__AVX2__)
+#define JSON_ESCAPE_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_ESCAPE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#if defined(JSON_ESCAPE_AVX2) || defined(JSON_ESCAPE_SSE2)
+static inline unsigned firstSetBit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return static_cast<unsigned>(idx);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+size_t findJsonEscapeScalar(const char* p, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (jsonNeedsEscape(p[i])) return i;
+    }
+    return n;
+}
+
+// Per block: eq('"') | eq('\\') | (max_u8(c, 0x1F) == 0x1F), i.e. unsigned c <= 0x1F.
+// Bytes >= 0x80 (UTF-8 continuation/lead bytes) are never flagged.
+size_t findJsonEscape(const char* p, size_t n) {
+    size_t i = 0;
+
+#if defined(JSON_ESCAPE_AVX2)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i slash = _mm256_set1_epi8('\\');
+    const __m256i ctrl  = _mm256_set1_epi8(0x1F);
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, slash)),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctrl), ctrl));
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+        if (mask) return i + firstSetBit(mask);
+    }
+#endif
+
+#if defined(JSON_ESCAPE_AVX2) || defined(JSON_ESCAPE_SSE2)
+    const __m128i quote16 = _mm_set1_epi8('"');
+    const __m128i slash16 = _mm_set1_epi8('\\');
+    const __m128i ctrl16  = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote16), _mm_cmpeq_epi8(v, slash16)),
+            _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl16), ctrl16));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+        if (mask) return i + firstSetBit(mask);
+    }
+#endif
+
+    return i + findJsonEscapeScalar(p + i, n - i);
+}
+
+size_t jsonEscapeSequence(char c, char out[6]) {
+    out[0] = '\\';
+    switch (c) {
+    case '"':  out[1] = '"';  return 2;
+    case '\\': out[1] = '\\'; return 2;
+    case '\b': out[1] = 'b';  return 2;
+    case '\f': out[1] = 'f';  return 2;
+    case '\n': out[1] = 'n';  return 2;
+    case '\r': out[1] = 'r';  return 2;
+    case '\t': out[1] = 't';  return 2;
+    default: break;
+    }
+    static const char hex[] = "0123456789abcdef";
+    const unsigned char u = static_cast<unsigned char>(c);
+    out[1] = 'u';
+    out[2] = '0';
+    out[3] = '0';
+    out[4] = hex[u >> 4];
+    out[5] = hex[u & 0xF];
+    return 6;
+}
+
+const char* jsonEscapeImpl() {
+#if defined(JSON_ESCAPE_AVX2)
+    return "avx2";
+#elif defined(JSON_ESCAPE_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,28 @@
+// ============================================================================
+// File: src/domain/JsonEscape.h
+// Vectorized scan for bytes that need JSON escaping (AVX2 / SSE2 / scalar)
+// ============================================================================
+#pragma once
+
+#include <cstddef>
+
+// '"', '\\' or a control character < 0x20
+inline bool jsonNeedsEscape(char c) {
+    const unsigned char u = static_cast<unsigned char>(c);
+    return u == '"' || u == '\\' || u < 0x20;
+}
+
+// Index of the first byte in [p, p + n) that must be escaped in a JSON string
+// ('"', '\\' or a control character < 0x20), or n if the run is clean.
+// The implementation is picked at compile time (__AVX2__, then SSE2, then scalar).
+size_t findJsonEscape(const char* p, size_t n);
+
+// Byte-at-a-time reference for findJsonEscape (also used for the tails)
+size_t findJsonEscapeScalar(const char* p, size_t n);
+
+// Writes the escape sequence for `c` (a byte findJsonEscape stopped at) into
+// `out` and returns its length: \" \\ \b \f \n \r \t or \u00XX.
+size_t jsonEscapeSequence(char c, char out[6]);
+
+// "avx2", "sse2" or "scalar"
+const char* jsonEscapeImpl();
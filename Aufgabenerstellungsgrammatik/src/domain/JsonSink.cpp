@@ -0,0 +1,122 @@
+// ============================================================================
+// File: src/domain/JsonSink.cpp
+// ============================================================================
+#include "domain/JsonSink.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+#include "domain/JsonEscape.h"
+
+JsonSink::JsonSink(std::FILE* f, JsonStyle s) : file(f), style(s) {}
+
+JsonSink::JsonSink(std::string& out, JsonStyle s) : str(&out), style(s) {}
+
+void JsonSink::flush() {
+    if (used == 0) return;
+    if (str) {
+        str->append(buf, used);
+    } else if (std::fwrite(buf, 1, used, file) != used) {
+        throw std::runtime_error("Could not write output file");
+    }
+    used = 0;
+}
+
+void JsonSink::append(const char* data, size_t n) {
+    while (n > 0) {
+        if (used == kBufferSize) flush();
+        const size_t chunk = std::min(n, kBufferSize - used);
+        std::memcpy(buf + used, data, chunk);
+        used += chunk;
+        data += chunk;
+        n -= chunk;
+    }
+}
+
+void JsonSink::newlineIndent() {
+    append('\n');
+    for (int i = 0; i < indent * 2; ++i) append(' ');
+}
+
+// Same decisions as prettyJsonDomain, one input byte at a time
+void JsonSink::put(char c) {
+    if (style == JsonStyle::Compact) {
+        append(c);
+        last = c;
+        return;
+    }
+
+    if (c == '\"') {
+        append(c);
+        if (last != '\\') inString = !inString;
+    } else if (!inString && (c == '{' || c == '[')) {
+        append(c);
+        indent++;
+        newlineIndent();
+    } else if (!inString && (c == '}' || c == ']')) {
+        indent--;
+        newlineIndent();
+        append(c);
+    } else if (!inString && c == ',') {
+        append(c);
+        newlineIndent();
+    } else {
+        append(c);
+    }
+    last = c;
+}
+
+JsonSink& JsonSink::operator<<(std::string_view text) {
+    for (char c : text) put(c);
+    return *this;
+}
+
+JsonSink& JsonSink::operator<<(char c) {
+    put(c);
+    return *this;
+}
+
+JsonSink& JsonSink::operator<<(int v) {
+    char tmp[16];
+    const auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    for (const char* p = tmp; p != r.ptr; ++p) put(*p);
+    return *this;
+}
+
+// Clean runs are located with findJsonEscape and copied in bulk.
+void JsonSink::escape(std::string_view s) {
+    const char* p = s.data();
+    size_t n = s.size();
+    char seq[6];
+    while (n > 0) {
+        const size_t clean = findJsonEscape(p, n);
+        append(p, clean);
+        if (clean == n) break;
+        append(seq, jsonEscapeSequence(p[clean], seq));
+        p += clean + 1;
+        n -= clean + 1;
+    }
+}
+
+void JsonSink::string(std::string_view s) {
+    put('\"');
+
+    // Inside a string the pretty state machine only copies bytes and never sees
+    // an unescaped quote, so the escaped contents can bypass it. If the quote
+    // toggle is out of sync (only after a value ending in a backslash, which
+    // prettyJsonDomain mishandles the same way) every byte goes through put().
+    if (style == JsonStyle::Compact || inString) {
+        escape(s);
+        if (!s.empty()) last = buf[used - 1];
+    } else {
+        char seq[6];
+        for (char c : s) {
+            if (jsonNeedsEscape(c)) *this << std::string_view(seq, jsonEscapeSequence(c, seq));
+            else put(c);
+        }
+    }
+
+    put('\"');
+}
@@ -0,0 +1,63 @@
+// ============================================================================
+// File: src/domain/JsonSink.h
+// Buffered single-pass JSON output (compact or pretty) with a bounded buffer
+// ============================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+enum class JsonStyle {
+    Compact, // "{ \"type\": ..., ... }" on one line (domainToJson)
+    Pretty   // byte-identical to prettyJsonDomain(domainToJson(...))
+};
+
+// Structural text goes through operator<<, string values through string().
+// In Pretty mode every structural byte runs through the same state machine as
+// prettyJsonDomain, so the output matches it byte for byte; string contents are
+// copied in bulk. Memory use is the fixed buffer, independent of output size.
+class JsonSink {
+public:
+    JsonSink(std::FILE* file, JsonStyle style); // written with fwrite, caller owns the FILE
+    JsonSink(std::string& out, JsonStyle style); // appended to `out`
+
+    JsonSink(const JsonSink&) = delete;
+    JsonSink& operator=(const JsonSink&) = delete;
+
+    JsonSink& operator<<(std::string_view text);
+    JsonSink& operator<<(const char* text) { return *this << std::string_view(text); }
+    JsonSink& operator<<(char c);
+    JsonSink& operator<<(int v);
+
+    // "..." with JSON escaping
+    void string(std::string_view s);
+
+    // Pushes the buffer to the target; throws std::runtime_error if fwrite fails.
+    void flush();
+
+private:
+    static constexpr size_t kBufferSize = 64 * 1024;
+
+    void put(char c); // one structural byte (pretty state machine)
+    void newlineIndent();
+    void append(const char* data, size_t n);
+    void append(char c) {
+        if (used == kBufferSize) flush();
+        buf[used++] = c;
+    }
+    void escape(std::string_view s);
+
+    std::FILE* file = nullptr;
+    std::string* str = nullptr;
+    JsonStyle style;
+
+    // prettyJsonDomain state
+    int indent = 0;
+    bool inString = false;
+    char last = 0; // previous byte of the compact stream
+
+    size_t used = 0;
+    char buf[kBufferSize];
+};
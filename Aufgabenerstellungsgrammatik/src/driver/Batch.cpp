@@ -0,0 +1,251 @@
+// ============================================================================
+// File: src/driver/Batch.cpp
+// ============================================================================
+#include "driver/Batch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#include "driver/WorkStealingPool.h"
+
+namespace fs = std::filesystem;
+
+// -------------------------
+// Input expansion
+// -------------------------
+static bool hasWildcard(const std::string& s) {
+    return s.find_first_of("*?") != std::string::npos;
+}
+
+// '*' = any run, '?' = any single char (no character classes)
+static bool globMatch(const char* pat, const char* str) {
+    const char* starPat = nullptr;
+    const char* starStr = nullptr;
+    while (*str) {
+        if (*pat == '?' || *pat == *str) {
+            ++pat;
+            ++str;
+        } else if (*pat == '*') {
+            starPat = pat++;
+            starStr = str;
+        } else if (starPat) {
+            pat = starPat + 1;
+            str = ++starStr;
+        } else {
+            return false;
+        }
+    }
+    while (*pat == '*') ++pat;
+    return *pat == '\0';
+}
+
+static void appendSorted(std::vector<std::string>& out, std::vector<std::string> found) {
+    std::sort(found.begin(), found.end());
+    out.insert(out.end(), found.begin(), found.end());
+}
+
+static void expandOne(const std::string& spec, std::vector<std::string>& out) {
+    if (!spec.empty() && spec[0] == '@') {
+        const std::string listPath = spec.substr(1);
+        std::ifstream list(listPath);
+        if (!list) throw std::runtime_error("Konnte Dateiliste nicht öffnen: " + listPath);
+
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t a = line.find_first_not_of(" \t");
+            if (a == std::string::npos || line[a] == '#') continue;
+            size_t b = line.find_last_not_of(" \t");
+            expandOne(line.substr(a, b - a + 1), out);
+        }
+        return;
+    }
+
+    fs::path p(spec);
+
+    if (hasWildcard(p.filename().string())) {
+        fs::path dir = p.has_parent_path() ? p.parent_path() : fs::path(".");
+        if (hasWildcard(dir.string())) {
+            throw std::runtime_error("Platzhalter nur im Dateinamen erlaubt: " + spec);
+        }
+        const std::string pattern = p.filename().string();
+
+        std::vector<std::string> found;
+        if (fs::is_directory(dir)) {
+            for (const auto& e : fs::directory_iterator(dir)) {
+                if (!e.is_regular_file()) continue;
+                if (globMatch(pattern.c_str(), e.path().filename().string().c_str())) {
+                    found.push_back(e.path().string());
+                }
+            }
+        }
+        if (found.empty()) throw std::runtime_error("Keine Dateien für Muster: " + spec);
+        appendSorted(out, std::move(found));
+        return;
+    }
+
+    if (fs::is_directory(p)) {
+        std::vector<std::string> found;
+        for (const auto& e : fs::directory_iterator(p)) {
+            if (e.is_regular_file() && e.path().extension() == ".txt") {
+                found.push_back(e.path().string());
+            }
+        }
+        appendSorted(out, std::move(found));
+        return;
+    }
+
+    // plain file (existence is reported per file by the compiler)
+    out.push_back(spec);
+}
+
+std::vector<std::string> expandInputs(const std::vector<std::string>& specs) {
+    std::vector<std::string> out;
+    for (const auto& s : specs) expandOne(s, out);
+    return out;
+}
+
+std::vector<std::string> outputPathsFor(const std::vector<std::string>& inputs,
+                                        const std::string& outDir,
+                                        const std::string& extension) {
+    std::vector<std::string> outs;
+    outs.reserve(inputs.size());
+
+    std::set<std::string> seen;
+    for (const auto& in : inputs) {
+        std::string out = (fs::path(outDir) / fs::path(in).stem()).string() + extension;
+        if (!seen.insert(out).second) {
+            throw std::runtime_error("Mehrere Eingaben schreiben nach " + out + " (" + in + ")");
+        }
+        outs.push_back(std::move(out));
+    }
+    return outs;
+}
+
+// -------------------------
+// Reporting
+// -------------------------
+double percentile(std::vector<double> xs, double p) {
+    if (xs.empty()) return 0.0;
+    std::sort(xs.begin(), xs.end());
+    long idx = static_cast<long>(std::ceil(p * xs.size())) - 1;
+    idx = std::clamp(idx, 0L, static_cast<long>(xs.size()) - 1);
+    return xs[static_cast<size_t>(idx)];
+}
+
+void printFileResult(const FileResult& r) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%9.2f ms  ", r.millis);
+    if (r.ok) {
+        std::cerr << "[ok]   " << buf << r.inputPath << " -> " << r.outputPath << "\n";
+    } else {
+        std::cerr << "[fail] " << buf << r.inputPath << ": " << r.error << "\n";
+        for (const auto& d : r.diagnostics) std::cerr << "         " << d << "\n";
+    }
+}
+
+void reportBatch(const std::vector<FileResult>& results, double wallMillis) {
+    std::vector<double> times;
+    times.reserve(results.size());
+    size_t ok = 0;
+    ParseStats parse;
+
+    for (const auto& r : results) {
+        times.push_back(r.millis);
+        parse += r.parse;
+        if (r.ok) ++ok;
+        printFileResult(r);
+    }
+
+    double sum = 0.0;
+    for (double t : times) sum += t;
+    const double mean = times.empty() ? 0.0 : sum / times.size();
+
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.1f", wallMillis);
+    std::cerr << "\n=== BATCH SUMMARY ===\n"
+              << "total=" << results.size() << ", ok=" << ok << ", fail=" << (results.size() - ok) << "\n"
+              << "total_ms=" << buf << "\n";
+    char line[160];
+    std::snprintf(line, sizeof(line), "mean_ms=%.2f  p50_ms=%.2f  p95_ms=%.2f  p99_ms=%.2f\n",
+                  mean, percentile(times, 0.50), percentile(times, 0.95), percentile(times, 0.99));
+    std::cerr << line;
+    std::cerr << "parse: native=" << parse.nativeParses << ", sll=" << parse.sllParses
+              << ", ll_fallback=" << parse.llFallbacks << ", cached=" << parse.cachedTasks << "\n";
+    if (wallMillis > 0.0) {
+        std::snprintf(line, sizeof(line), "throughput=%.2f files/sec\n",
+                      results.size() / (wallMillis / 1000.0));
+        std::cerr << line;
+    }
+}
+
+// -------------------------
+// Driver
+// -------------------------
+std::vector<FileResult> compileAll(const std::vector<std::string>& inputs,
+                                   const std::vector<std::string>& outputs,
+                                   size_t jobs, const CompilerOptions& options) {
+    if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min(jobs, inputs.size());
+
+    std::vector<FileResult> results(inputs.size());
+
+    if (jobs <= 1) {
+        Compiler compiler(options);
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            results[i] = compiler.compileFile(inputs[i], outputs[i]);
+        }
+        return results;
+    }
+
+    // One Compiler per worker; the generated lexer/parser keep their ATN and
+    // DFA caches in per-class static data, so all workers share the warm-up.
+    std::vector<std::unique_ptr<Compiler>> compilers(jobs);
+    WorkStealingPool pool(jobs);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        pool.submit([&, i](size_t worker) {
+            if (!compilers[worker]) compilers[worker] = std::make_unique<Compiler>(options);
+            results[i] = compilers[worker]->compileFile(inputs[i], outputs[i]);
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+int runBatch(const BatchOptions& opts) {
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+    try {
+        inputs = expandInputs(opts.inputs);
+        outputs = outputPathsFor(inputs, opts.outDir, outputExtension(opts.compiler.format));
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+
+    if (inputs.empty()) {
+        std::cerr << "Keine Eingabedateien gefunden.\n";
+        return 1;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto t0 = Clock::now();
+
+    std::vector<FileResult> results = compileAll(inputs, outputs, opts.jobs, opts.compiler);
+
+    const double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    reportBatch(results, wallMs);
+
+    for (const auto& r : results) {
+        if (!r.ok) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+// ============================================================================
+// File: src/driver/Batch.h
+// Batch mode: many DSL files -> one output directory, one warm Compiler
+// ============================================================================
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "driver/Compiler.h"
+
+struct BatchOptions {
+    std::vector<std::string> inputs; // files, directories, globs (*, ?) or @listfile
+    std::string outDir;
+    size_t jobs = 1; // -j N; 0 = hardware concurrency
+    CompilerOptions compiler;
+};
+
+// Resolves files / directories (*.txt) / globs in the last path component / @listfiles.
+// Result keeps argument order; entries from one directory or glob are sorted.
+std::vector<std::string> expandInputs(const std::vector<std::string>& specs);
+
+// <outDir>/<stem><extension> for every input; throws on duplicate stems.
+std::vector<std::string> outputPathsFor(const std::vector<std::string>& inputs,
+                                        const std::string& outDir,
+                                        const std::string& extension = ".json");
+
+// Nearest-rank percentile, p in [0, 1]; 0 for an empty sample.
+double percentile(std::vector<double> xs, double p);
+
+// "[ok]   <ms>  in -> out" or "[fail] <ms>  in: error" plus diagnostics, to stderr.
+void printFileResult(const FileResult& r);
+
+// Prints per-file status lines and a timing summary to stderr.
+void reportBatch(const std::vector<FileResult>& results, double wallMillis);
+
+// Compiles inputs[i] -> outputs[i]; results keep input order regardless of `jobs`.
+std::vector<FileResult> compileAll(const std::vector<std::string>& inputs,
+                                   const std::vector<std::string>& outputs,
+                                   size_t jobs, const CompilerOptions& options = {});
+
+// Returns the process exit code (0 = all files ok).
+int runBatch(const BatchOptions& opts);
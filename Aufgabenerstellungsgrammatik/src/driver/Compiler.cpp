@@ -0,0 +1,326 @@
+// ============================================================================
+// File: src/driver/Compiler.cpp
+// ============================================================================
+#include "driver/Compiler.h"
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+#include "ir/IRBuilder.h"
+#include "ir/IR.h"
+#include "domain/DomainBinary.h"
+#include "domain/DomainConvert.h"
+#include "domain/DomainJson.h"
+#include "driver/SourceFile.h"
+#include "driver/SplitCompile.h"
+#include "driver/TaskCache.h"
+#include "driver/TokenDump.h"
+#include "native/NativeParser.h"
+
+using namespace antlr4;
+
+void DiagnosticListener::syntaxError(Recognizer*, Token*, size_t line, size_t charPositionInLine,
+                                     const std::string& msg, std::exception_ptr) {
+    messages.push_back("line " + std::to_string(line) + ":" +
+                       std::to_string(charPositionInLine) + " " + msg);
+}
+
+std::string readInputFile(const std::string& path) {
+    SourceFile file(path);
+    return std::string(file.text());
+}
+
+void applyScoringPolicy(ProgramD& prog, const CompilerOptions& opts) {
+    if (opts.sortingScore == SortingScore::Position) return;
+    for (TaskD& task : prog.tasks) {
+        auto* sorting = std::get_if<SortingTaskD>(&task);
+        if (!sorting) continue;
+        for (SortingLineIR& line : sorting->lines) {
+            if (line.points.scoringMode == ScoringModeIR::PartialPerCorrect) {
+                line.points.scoringMode = ScoringModeIR::PartialInOrder;
+            }
+        }
+    }
+}
+
+const char* outputLabel(OutputFormat format) {
+    return format == OutputFormat::Bin ? "Domain-Binärdatei" : "Domain-JSON";
+}
+
+Compiler::Compiler(const CompilerOptions& options)
+    : lexer(&inputStream), tokens(&lexer), parser(&tokens),
+      bailStrategy(std::make_shared<BailErrorStrategy>()),
+      defaultStrategy(std::make_shared<DefaultErrorStrategy>()),
+      opts(options) {
+    lexer.removeErrorListeners();
+    lexer.addErrorListener(&listener);
+    parser.removeErrorListeners();
+    parser.addErrorListener(&listener);
+}
+
+// Stage 1: SLL prediction + BailErrorStrategy, parser listeners muted.
+// Stage 2 (only if stage 1 bailed or an embedded action reported an error):
+// rewind the already buffered tokens and re-parse in full LL mode with the
+// default error strategy, so diagnostics are identical to a plain LL parse.
+template <class Rule>
+auto Compiler::parseTwoStage(Rule rule) -> decltype(rule()) {
+    auto* interp = parser.getInterpreter<atn::ParserATNSimulator>();
+
+    interp->setPredictionMode(atn::PredictionMode::SLL);
+    parser.setErrorHandler(bailStrategy);
+    parser.removeErrorListeners();
+
+    decltype(rule()) ctx = nullptr;
+    try {
+        ctx = rule();
+    } catch (const ParseCancellationException&) {
+        ctx = nullptr;
+    }
+
+    parser.addErrorListener(&listener);
+    parser.setErrorHandler(defaultStrategy);
+    interp->setPredictionMode(atn::PredictionMode::LL);
+
+    // notifyErrorListeners() in `reason` counts as a syntax error without bailing
+    if (ctx && parser.getNumberOfSyntaxErrors() == 0) {
+        ++parseStats.sllParses;
+        return ctx;
+    }
+
+    ++parseStats.llFallbacks;
+    parser.reset(); // seeks the token stream back to 0, clears the error count
+    return rule();
+}
+
+// Re-seats the warm lexer/parser on new input (ATN/DFA caches survive).
+void Compiler::reseat(const char* data, size_t length, const std::string& sourceName,
+                      size_t firstLine) {
+    listener.messages.clear();
+
+    if (opts.lexer == LexerKind::Native) {
+        // tokens are views into data[0, length) - the caller keeps it alive
+        nativeSource.reset(std::string_view(data, length), sourceName, firstLine, &listener);
+        tokens.setTokenSource(&nativeSource);
+    } else {
+        inputStream.load(data, length, false);
+        inputStream.name = sourceName;
+        lexer.setInputStream(&inputStream);
+        lexer.setLine(firstLine);
+        lexer.setCharPositionInLine(0);
+        tokens.setTokenSource(&lexer);
+    }
+    parser.setTokenStream(&tokens);
+}
+
+void Compiler::clearDfaCache() {
+    lexer.getInterpreter<atn::LexerATNSimulator>()->clearDFA();
+    parser.getInterpreter<atn::ParserATNSimulator>()->clearDFA();
+}
+
+bool Compiler::compile(std::string_view input, const std::string& sourceName,
+                       ProgramD& out, FileResult& res) {
+    // ------------------------------------------------------------
+    // Native parse: source -> IR without a parse tree. Anything it does not
+    // accept goes through ANTLR below, which owns the error messages.
+    // ------------------------------------------------------------
+    if (useNative()) {
+        ProgramIR progIR;
+        NativeParser native(input, *progIR.arenas.emplace_back(std::make_shared<Arena>()));
+        if (native.parseProgram(progIR)) {
+            ++parseStats.nativeParses;
+            try {
+                out = convertProgram(std::move(progIR));
+                applyScoringPolicy(out, opts);
+            } catch (const std::exception& ex) {
+                res.error = std::string("Fehler beim Konvertieren IR -> Domain: ") + ex.what();
+                return false;
+            }
+            return true;
+        }
+    }
+
+    // ------------------------------------------------------------
+    // ANTLR parse
+    // ------------------------------------------------------------
+    reseat(input.data(), input.size(), sourceName, 1);
+
+    // Tokens are pulled lazily by the parser; only the debug dump fills the stream.
+    auto* progCtx = parseTwoStage([this] { return parser.prog(); });
+    if (!opts.tokenDumpPath.empty()) {
+        try {
+            dumpTokens(tokens, lexer.getVocabulary(), opts.tokenDumpPath);
+        } catch (const std::exception& ex) {
+            res.error = ex.what();
+            return false;
+        }
+    }
+    if (parser.getNumberOfSyntaxErrors() > 0 || !listener.messages.empty()) {
+        res.diagnostics = std::move(listener.messages);
+        listener.messages.clear();
+        res.error = "Syntaxfehler in Datei: " + sourceName;
+        return false;
+    }
+
+    // ------------------------------------------------------------
+    // ParseTree -> IR -> Domain
+    // ------------------------------------------------------------
+    try {
+        ProgramIR progIR;
+        IRBuilder builder(input, &tokens, *progIR.arenas.emplace_back(std::make_shared<Arena>()),
+                          opts.lexer == LexerKind::Native);
+        builder.buildProgram(progCtx, progIR);
+        out = convertProgram(std::move(progIR));
+        applyScoringPolicy(out, opts);
+    } catch (const std::exception& ex) {
+        res.error = std::string("Fehler beim Konvertieren IR -> Domain: ") + ex.what();
+        return false;
+    }
+
+    return true;
+}
+
+bool Compiler::compileTask(std::string_view text, const std::string& sourceName, size_t firstLine,
+                           Arena& arena, TaskIR& out, std::vector<std::string>& diagnostics,
+                           std::string& error) {
+    if (useNative()) {
+        NativeParser native(text, arena, firstLine);
+        if (native.parseTaskUnit(out)) {
+            ++parseStats.nativeParses;
+            return true;
+        }
+        out = TaskIR{};
+    }
+
+    reseat(text.data(), text.size(), sourceName, firstLine);
+
+    auto* unitCtx = parseTwoStage([this] { return parser.task_unit(); });
+    if (parser.getNumberOfSyntaxErrors() > 0 || !listener.messages.empty()) {
+        diagnostics.insert(diagnostics.end(), listener.messages.begin(), listener.messages.end());
+        listener.messages.clear();
+        error = "Syntaxfehler in Datei: " + sourceName;
+        return false;
+    }
+
+    try {
+        IRBuilder builder(text, &tokens, arena, opts.lexer == LexerKind::Native);
+        builder.buildTask(unitCtx->task_definition(), out);
+    } catch (const std::exception& ex) {
+        error = std::string("Fehler beim Konvertieren IR -> Domain: ") + ex.what();
+        return false;
+    }
+    return true;
+}
+
+bool Compiler::compileCached(std::string_view input, const std::string& sourceName, TaskCache& cache,
+                             ProgramD& out, FileResult& res) {
+    // the token dump wants the whole file's token stream
+    std::vector<TaskChunk> chunks;
+    if (!opts.tokenDumpPath.empty() || !splitTasks(input, chunks) || chunks.empty()) {
+        return compile(input, sourceName, out, res);
+    }
+
+    // parsed tasks and decoded cache records share one arena
+    ProgramD prog;
+    Arena& arena = *prog.arenas.emplace_back(std::make_shared<Arena>());
+    prog.tasks.reserve(chunks.size());
+
+    bool ok = true;
+    std::vector<std::string> chunkDiagnostics; // replaced by the whole-file ones on failure
+    for (const TaskChunk& ch : chunks) {
+        const std::string_view text(input.data() + ch.begin, ch.end - ch.begin);
+        try {
+            if (const auto record = cache.find(text)) {
+                if (ok) prog.tasks.push_back(taskFromBinary(*record, arena));
+                ++parseStats.cachedTasks;
+                continue;
+            }
+
+            TaskIR task;
+            std::string error;
+            if (!compileTask(text, sourceName, ch.line, arena, task, chunkDiagnostics, error)) {
+                if (ok) res.error = error;
+                ok = false;
+                continue;
+            }
+
+            TaskD d = convertTask(std::move(task));
+            cache.store(text, d);
+            if (ok) prog.tasks.push_back(std::move(d));
+        } catch (const std::exception& ex) {
+            if (ok) res.error = std::string("Fehler beim Konvertieren IR -> Domain: ") + ex.what();
+            ok = false;
+        }
+    }
+    if (!ok) {
+        // the valid tasks are cached by now; the diagnostics come from a
+        // whole-file parse so they match the uncached run exactly
+        std::string chunkError = std::move(res.error);
+        res.error.clear();
+        ProgramD whole;
+        compile(input, sourceName, whole, res);
+        if (res.error.empty()) res.error = std::move(chunkError);
+        return false;
+    }
+
+    applyScoringPolicy(prog, opts);
+    out = std::move(prog);
+    return true;
+}
+
+FileResult Compiler::compileFile(const std::string& inputPath, const std::string& outputPath) {
+    using Clock = std::chrono::steady_clock;
+    const auto t0 = Clock::now();
+
+    FileResult res;
+    res.inputPath = inputPath;
+    res.outputPath = outputPath;
+
+    const ParseStats before = parseStats;
+    auto finish = [&](bool ok) {
+        res.parse.nativeParses = parseStats.nativeParses - before.nativeParses;
+        res.parse.sllParses = parseStats.sllParses - before.sllParses;
+        res.parse.llFallbacks = parseStats.llFallbacks - before.llFallbacks;
+        res.parse.cachedTasks = parseStats.cachedTasks - before.cachedTasks;
+        res.ok = ok;
+        res.millis = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        return res;
+    };
+
+    // mapped once; lexer, parser and IRBuilder all work on this view
+    std::optional<SourceFile> file;
+    try {
+        file.emplace(inputPath, opts.mapInput);
+    } catch (const std::exception& ex) {
+        res.error = ex.what();
+        return finish(false);
+    }
+    const std::string_view input = file->text();
+
+    if (input.empty()) {
+        res.error = "Eingabedatei ist leer: " + inputPath;
+        return finish(false);
+    }
+
+    ProgramD progD;
+    if (opts.cacheDir.empty()) {
+        if (!compile(input, inputPath, progD, res)) return finish(false);
+    } else {
+        TaskCache cache(opts.cacheDir, inputPath);
+        const bool ok = compileCached(input, inputPath, cache, progD, res);
+        cache.save(); // best effort, also keeps the valid tasks of a failed compile
+        if (!ok) return finish(false);
+    }
+
+    try {
+        writeDomainOutput(progD, outputPath, opts.format);
+    } catch (const std::exception& ex) {
+        res.error = std::string("Fehler beim Schreiben der ") + outputLabel(opts.format) + ": " + ex.what();
+        return finish(false);
+    }
+
+    return finish(true);
+}
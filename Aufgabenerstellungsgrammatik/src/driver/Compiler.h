@@ -0,0 +1,164 @@
+// ============================================================================
+// File: src/driver/Compiler.h
+// Reusable DSL -> Domain -> JSON pipeline (one warm lexer/parser per instance)
+// ============================================================================
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "antlr4-runtime.h"
+#include "AufgabenerstellungsgrammatikLexer.h"
+#include "AufgabenerstellungsgrammatikParser.h"
+
+#include "ir/IR.h"
+#include "domain/Domain.h"
+#include "domain/DomainOutput.h"
+#include "native/NativeTokenSource.h"
+
+class TaskCache;
+
+// Collects syntax errors as "line L:C msg" (same format as ANTLR's console listener)
+class DiagnosticListener : public antlr4::BaseErrorListener {
+public:
+    void syntaxError(antlr4::Recognizer* recognizer, antlr4::Token* offendingSymbol,
+                     size_t line, size_t charPositionInLine,
+                     const std::string& msg, std::exception_ptr e) override;
+
+    std::vector<std::string> messages;
+};
+
+// Parse counters: native parser first, then ANTLR SLL + BailErrorStrategy, full LL only on failure
+struct ParseStats {
+    size_t nativeParses = 0; // parses done by NativeParser (no parse tree)
+    size_t sllParses = 0;    // parses that finished in the SLL pass
+    size_t llFallbacks = 0;  // parses that had to be repeated in LL mode
+    size_t cachedTasks = 0;  // tasks taken from the TaskCache without parsing
+
+    ParseStats& operator+=(const ParseStats& o) {
+        nativeParses += o.nativeParses;
+        sllParses += o.sllParses;
+        llFallbacks += o.llFallbacks;
+        cachedTasks += o.cachedTasks;
+        return *this;
+    }
+};
+
+struct FileResult {
+    std::string inputPath;
+    std::string outputPath;
+    bool ok = false;
+    std::string error;                    // first error for reports (empty if ok)
+    std::vector<std::string> diagnostics; // syntax errors in source order
+    double millis = 0.0;                  // read + compile + write
+    ParseStats parse;
+};
+
+enum class LexerKind {
+    Native, // hand-written zero-copy lexer (default hot path)
+    Antlr   // generated AufgabenerstellungsgrammatikLexer (reference)
+};
+
+enum class FrontendKind {
+    Native, // NativeParser straight to IR; falls back to ANTLR on any error
+    Antlr   // parse tree + IRBuilder (reference, produces the diagnostics)
+};
+
+// Partial credit of Umordnung lines without a point count (--sorting-score)
+enum class SortingScore {
+    Position, // 1 point per item on its correct position (grammar default)
+    InOrder   // 1 point per item of the longest correctly ordered subsequence
+};
+
+struct CompilerOptions {
+    LexerKind lexer = LexerKind::Native;
+    FrontendKind frontend = FrontendKind::Native;
+    OutputFormat format = OutputFormat::Json;
+
+    // Debug: write all tokens of every compiled file here (see TokenDump.h).
+    // Empty = off; the default path never fills the token stream up front.
+    std::string tokenDumpPath;
+
+    // Per-task cache directory (see TaskCache.h); empty = off.
+    std::string cacheDir;
+
+    // compileFile maps its input (see SourceFile); false reads it into memory
+    // instead, for inputs another process may truncate mid-compile (--watch).
+    bool mapInput = true;
+
+    SortingScore sortingScore = SortingScore::Position;
+};
+
+// Keeps one lexer/parser pair alive so the ATN/DFA caches stay warm across files.
+// Not thread-safe: use one instance per thread.
+class Compiler {
+public:
+    explicit Compiler(const CompilerOptions& options = {});
+
+    Compiler(const Compiler&) = delete;
+    Compiler& operator=(const Compiler&) = delete;
+
+    // Parses + converts `input`; on failure `res.error`/`res.diagnostics` are set.
+    // `input` is viewed, not copied (tokens point into it).
+    bool compile(std::string_view input, const std::string& sourceName,
+                 ProgramD& out, FileResult& res);
+
+    // Parses one task cut out of a larger file (task_unit). `firstLine` is the
+    // line of text[0] in the original file, so diagnostics keep their positions.
+    // The task's strings and vectors live in `arena`; the caller keeps it with the IR.
+    bool compileTask(std::string_view text, const std::string& sourceName, size_t firstLine,
+                     Arena& arena, TaskIR& out, std::vector<std::string>& diagnostics,
+                     std::string& error);
+
+    // Like compile(), but tasks whose source text is in `cache` are decoded
+    // instead of parsed, and newly compiled tasks are added to it. Files that
+    // splitTasks() rejects are compiled as a whole, without the cache.
+    bool compileCached(std::string_view input, const std::string& sourceName, TaskCache& cache,
+                       ProgramD& out, FileResult& res);
+
+    // read -> compile -> write JSON, with timing; uses the TaskCache if opts.cacheDir is set
+    FileResult compileFile(const std::string& inputPath, const std::string& outputPath);
+
+    // Drops the ATN simulators' DFA caches. They are shared by every lexer and
+    // parser instance of the grammar, so no other Compiler may be parsing.
+    void clearDfaCache();
+
+    // Totals over every parse done by this instance
+    const ParseStats& stats() const { return parseStats; }
+
+private:
+    template <class Rule>
+    auto parseTwoStage(Rule rule) -> decltype(rule());
+
+    void reseat(const char* data, size_t length, const std::string& sourceName, size_t firstLine);
+
+    // the token dump needs a token stream, so it always takes the ANTLR path
+    bool useNative() const {
+        return opts.frontend == FrontendKind::Native && opts.tokenDumpPath.empty();
+    }
+
+    antlr4::ANTLRInputStream inputStream;
+    AufgabenerstellungsgrammatikLexer lexer;
+    NativeTokenSource nativeSource;
+    antlr4::CommonTokenStream tokens;
+    AufgabenerstellungsgrammatikParser parser;
+    DiagnosticListener listener;
+    std::shared_ptr<antlr4::BailErrorStrategy> bailStrategy;
+    std::shared_ptr<antlr4::DefaultErrorStrategy> defaultStrategy;
+    ParseStats parseStats;
+    CompilerOptions opts;
+};
+
+// Applies the scoring options (sortingScore) to a compiled program. Parsers
+// and the TaskCache always produce the grammar defaults; every compile path
+// (compile, compileCached, compileSplit) calls this on its result.
+void applyScoringPolicy(ProgramD& prog, const CompilerOptions& opts);
+
+// "Domain-JSON" / "Domain-Binärdatei" for messages
+const char* outputLabel(OutputFormat format);
+
+// Reads a whole file as UTF-8 (see SourceFile); throws std::runtime_error if it
+// cannot be opened. The compile paths use SourceFile directly and avoid this copy.
+std::string readInputFile(const std::string& path);
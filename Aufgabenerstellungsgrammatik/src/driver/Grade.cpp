@@ -0,0 +1,231 @@
+// ============================================================================
+// File: src/driver/Grade.cpp
+// ============================================================================
+#include "driver/Grade.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "domain/DomainBinary.h"
+#include "domain/JsonSink.h"
+#include "driver/SourceFile.h"
+#include "driver/WorkStealingPool.h"
+#include "grading/Grader.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kBlockBytes = 16 * 1024 * 1024; // read size; a block is graded, then written
+constexpr size_t kChunkLines = 2048;              // lines per pool job
+
+struct LineRef {
+    size_t offset = 0;
+    size_t length = 0;
+    size_t number = 0; // 1-based line in the input
+};
+
+struct ChunkResult {
+    std::string out;
+    size_t submissions = 0;
+    size_t malformed = 0;
+    long long points = 0;
+};
+
+ProgramD loadProgram(const GradeOptions& opts) {
+    if (fs::path(opts.programPath).extension() == ".bin") {
+        ProgramD prog = readDomainBinaryFile(opts.programPath);
+        applyScoringPolicy(prog, opts.compiler); // --sorting-score=lis also upgrades a file compiled without it
+        return prog;
+    }
+
+    SourceFile file(opts.programPath);
+    Compiler compiler(opts.compiler);
+    ProgramD prog;
+    FileResult res;
+    if (!compiler.compile(file.text(), opts.programPath, prog, res)) {
+        for (const auto& d : res.diagnostics) std::cerr << d << "\n";
+        throw std::runtime_error(res.error);
+    }
+    return prog; // IR strings are interned in the program's arenas, not views into `file`
+}
+
+void writeScore(JsonSink& out, const SubmissionScore& s, size_t lineNumber) {
+    out << "{";
+    if (!s.error.empty() || s.id.empty()) out << "\"line\": " << static_cast<int>(lineNumber) << ", ";
+    if (!s.id.empty()) {
+        out << "\"id\": ";
+        if (s.idIsString) out.string(s.id);
+        else out << s.id;
+        out << ", ";
+    }
+    if (!s.error.empty()) {
+        out << "\"error\": ";
+        out.string(s.error);
+        out << "}\n";
+        return;
+    }
+    out << "\"points\": " << s.points << ", \"tasks\": [";
+    for (size_t i = 0; i < s.tasks.size(); ++i) {
+        if (i) out << ", ";
+        out << s.tasks[i];
+    }
+    out << "]}\n";
+}
+
+// Non-empty lines of data[0, size); `lineNumber` counts every line
+void splitLines(const char* data, size_t size, size_t& lineNumber, std::vector<LineRef>& out) {
+    out.clear();
+    for (size_t pos = 0; pos < size;) {
+        const char* nl = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+        const size_t end = nl ? static_cast<size_t>(nl - data) : size;
+        size_t len = end - pos;
+        if (len > 0 && data[pos + len - 1] == '\r') --len;
+        ++lineNumber;
+
+        bool blank = true;
+        for (size_t i = pos; i < pos + len && blank; ++i) blank = data[i] == ' ' || data[i] == '\t';
+        if (!blank) out.push_back({pos, len, lineNumber});
+        pos = end + 1;
+    }
+}
+
+} // namespace
+
+int runGrade(const GradeOptions& opts) {
+    const auto t0 = Clock::now();
+
+    ProgramD program;
+    try {
+        program = loadProgram(opts);
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    const Grader grader(program, opts.match);
+
+    const bool fromStdin = opts.responsesPath == "-";
+    const bool toStdout = opts.outputPath == "-";
+    std::FILE* in = fromStdin ? stdin : std::fopen(opts.responsesPath.c_str(), "rb");
+    if (!in) {
+        std::cerr << "Konnte Eingabedatei nicht öffnen: " << opts.responsesPath << "\n";
+        return 1;
+    }
+    std::FILE* out = toStdout ? stdout : std::fopen(opts.outputPath.c_str(), "wb");
+    if (!out) {
+        std::cerr << "Konnte Ausgabedatei nicht öffnen: " << opts.outputPath << "\n";
+        if (!fromStdin) std::fclose(in);
+        return 1;
+    }
+
+    WorkStealingPool pool(opts.jobs ? opts.jobs : std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::unique_ptr<JsonDocument>> docs(pool.size()); // one per worker
+
+    size_t submissions = 0;
+    size_t malformed = 0;
+    long long points = 0;
+    size_t lineNumber = 0;
+    int rc = 0;
+
+    // Lines are graded in place, straight in the read buffer; the unfinished
+    // last line of a block moves to the front of the next one.
+    std::string block;
+    std::vector<LineRef> lines;
+    std::vector<ChunkResult> chunks;
+    size_t carry = 0;
+    for (bool eof = false; !eof;) {
+        block.resize(carry + kBlockBytes);
+        const size_t n = std::fread(&block[carry], 1, kBlockBytes, in);
+        if (n < kBlockBytes) {
+            if (std::ferror(in)) {
+                std::cerr << "Fehler beim Lesen: " << opts.responsesPath << "\n";
+                rc = 1;
+                break;
+            }
+            eof = true;
+        }
+        const size_t size = carry + n;
+
+        size_t cut = size;
+        if (!eof) {
+            const size_t nl = std::string_view(block.data(), size).rfind('\n');
+            if (nl == std::string_view::npos) { // one line longer than the block: keep reading
+                carry = size;
+                continue;
+            }
+            cut = nl + 1;
+        }
+
+        splitLines(block.data(), cut, lineNumber, lines);
+        chunks.assign((lines.size() + kChunkLines - 1) / kChunkLines, ChunkResult{});
+        for (size_t c = 0; c < chunks.size(); ++c) {
+            pool.submit([&, c](size_t worker) {
+                if (!docs[worker]) docs[worker] = std::make_unique<JsonDocument>();
+                ChunkResult& r = chunks[c];
+                SubmissionScore score;
+                JsonSink sink(r.out, JsonStyle::Compact);
+
+                const size_t last = std::min(lines.size(), (c + 1) * kChunkLines);
+                for (size_t i = c * kChunkLines; i < last; ++i) {
+                    grader.grade(&block[lines[i].offset], lines[i].length, *docs[worker], score);
+                    writeScore(sink, score, lines[i].number);
+                    ++r.submissions;
+                    if (!score.error.empty()) ++r.malformed;
+                    else r.points += score.points;
+                }
+                sink.flush();
+            });
+        }
+        pool.wait();
+
+        for (const ChunkResult& r : chunks) {
+            if (std::fwrite(r.out.data(), 1, r.out.size(), out) != r.out.size()) {
+                std::cerr << "Fehler beim Schreiben: " << opts.outputPath << "\n";
+                rc = 1;
+                eof = true;
+                break;
+            }
+            submissions += r.submissions;
+            malformed += r.malformed;
+            points += r.points;
+        }
+
+        carry = size - cut;
+        std::memmove(&block[0], block.data() + cut, carry);
+    }
+
+    if (!fromStdin) std::fclose(in);
+    if (toStdout) std::fflush(out);
+    else if (std::fclose(out) != 0 && rc == 0) {
+        std::cerr << "Fehler beim Schreiben: " << opts.outputPath << "\n";
+        rc = 1;
+    }
+    if (rc != 0) return rc;
+
+    const double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    const size_t ok = submissions - malformed;
+
+    char line[160];
+    std::cerr << "\n=== GRADE SUMMARY ===\n"
+              << "submissions=" << submissions << ", ok=" << ok << ", malformed=" << malformed
+              << ", tasks=" << grader.taskCount() << ", max_points=" << grader.maxPoints() << "\n";
+    std::cerr << "max_per_task=[";
+    for (size_t i = 0; i < grader.taskCount(); ++i) std::cerr << (i ? ", " : "") << grader.maxPoints(i);
+    std::cerr << "]\n";
+    std::snprintf(line, sizeof(line), "mean_points=%.3f\n", ok ? static_cast<double>(points) / ok : 0.0);
+    std::cerr << line;
+    std::snprintf(line, sizeof(line), "wall_ms=%.1f  throughput=%.0f submissions/sec\n", wallMs,
+                  wallMs > 0.0 ? submissions / (wallMs / 1000.0) : 0.0);
+    std::cerr << line;
+    return 0;
+}
@@ -0,0 +1,28 @@
+// ============================================================================
+// File: src/driver/Grade.h
+// --grade: score a JSONL stream of student submissions against one program
+// ============================================================================
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "driver/Compiler.h"
+#include "grading/TextMatch.h"
+
+struct GradeOptions {
+    std::string programPath;   // DSL source, or a --format=bin output (*.bin)
+    std::string responsesPath; // JSONL (see grading/Grader.h), "-" = stdin
+    std::string outputPath;    // JSONL, one line per submission in input order, "-" = stdout
+    size_t jobs = 0;           // worker threads; 0 = hardware concurrency
+    CompilerOptions compiler;  // for DSL sources
+    MatchOptions match;        // --fold / --max-edits for Lückentext and Textkorrektur
+};
+
+// Output per non-empty input line:
+//   {"id": "s42", "points": 7, "tasks": [2, 0, 5]}
+//   {"line": 17, "id": "s43", "error": "..."}   (malformed submission)
+// A summary (submissions, max points, mean, throughput) goes to stderr.
+// Returns 0 if the program loaded and the streams could be read/written;
+// malformed submissions are reported per line, not as a failure.
+int runGrade(const GradeOptions& opts);
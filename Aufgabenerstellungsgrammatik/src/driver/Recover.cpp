@@ -0,0 +1,240 @@
+// ============================================================================
+// File: src/driver/Recover.cpp
+// ============================================================================
+#include "driver/Recover.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "domain/DomainBinary.h"
+#include "domain/DomainConvert.h"
+#include "domain/DomainOutput.h"
+#include "domain/JsonSink.h"
+#include "driver/SourceFile.h"
+#include "driver/SplitCompile.h"
+#include "driver/TaskCache.h"
+
+namespace {
+
+// One token of ANTLR's display form starting at s[i]: a quoted literal
+// ('...' with backslash escapes) or a name like NEWLINE / <EOF>.
+size_t tokenEnd(std::string_view s, size_t i) {
+    if (i < s.size() && s[i] == '\'') {
+        for (++i; i < s.size(); ++i) {
+            if (s[i] == '\\') ++i;
+            else if (s[i] == '\'') return i + 1;
+        }
+        return s.size();
+    }
+    while (i < s.size() && s[i] != ' ' && s[i] != ',' && s[i] != '}') ++i;
+    return i;
+}
+
+// "{';', NEWLINE}" or a single token -> its elements
+std::vector<std::string> tokenSet(std::string_view s) {
+    std::vector<std::string> out;
+    if (s.empty()) return out;
+    if (s[0] != '{') {
+        out.emplace_back(s.substr(0, tokenEnd(s, 0)));
+        return out;
+    }
+    for (size_t i = 1; i < s.size() && s[i] != '}';) {
+        const size_t end = tokenEnd(s, i);
+        if (end == i) break;
+        out.emplace_back(s.substr(i, end - i));
+        i = end;
+        while (i < s.size() && (s[i] == ',' || s[i] == ' ')) ++i;
+    }
+    return out;
+}
+
+} // namespace
+
+TaskDiagnostic parseDiagnostic(const std::string& message) {
+    TaskDiagnostic d;
+    d.message = message;
+
+    // "line L:C msg"
+    unsigned long line = 0, column = 0;
+    int consumed = 0;
+    if (std::sscanf(message.c_str(), "line %lu:%lu %n", &line, &column, &consumed) >= 2 && consumed > 0) {
+        d.line = line;
+        d.column = column;
+        d.message = message.substr(static_cast<size_t>(consumed));
+    }
+
+    const std::string_view msg = d.message;
+    if (const size_t p = msg.find(" expecting "); p != std::string_view::npos) {
+        d.expected = tokenSet(msg.substr(p + 11));
+    } else if (msg.rfind("missing ", 0) == 0) {
+        d.expected = tokenSet(msg.substr(8));
+    }
+    return d;
+}
+
+bool compileRecovering(std::string_view input, const std::string& sourceName, size_t jobs,
+                       ProgramD& out, RecoverReport& report, FileResult& res,
+                       const CompilerOptions& options, TaskCache* cache) {
+    std::vector<TaskChunk> chunks;
+    splitTaskUnits(input, chunks);
+    report = RecoverReport();
+    report.tasks = chunks.size();
+
+    auto chunkText = [&](const TaskChunk& ch) { return input.substr(ch.begin, ch.end - ch.begin); };
+
+    std::vector<std::shared_ptr<const std::string>> cached(chunks.size());
+    std::vector<bool> skip(chunks.size(), false);
+    if (cache) {
+        for (size_t c = 0; c < chunks.size(); ++c) {
+            cached[c] = cache->find(chunkText(chunks[c]));
+            skip[c] = cached[c] != nullptr;
+        }
+    }
+
+    std::vector<ChunkResult> parts;
+    ProgramD prog;
+    prog.arenas = compileChunks(input, chunks, skip, sourceName, jobs, options, parts, res.parse);
+    prog.tasks.reserve(chunks.size());
+
+    // merge in source order; unlike compileSplit a failed task only drops itself
+    Arena* decodeArena = nullptr;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        ChunkResult& p = parts[c];
+        res.diagnostics.insert(res.diagnostics.end(), p.diagnostics.begin(), p.diagnostics.end());
+        std::string error = p.error;
+        if (cached[c] || p.ok) {
+            try {
+                if (cached[c]) {
+                    if (!decodeArena) decodeArena = prog.arenas.emplace_back(std::make_shared<Arena>()).get();
+                    prog.tasks.push_back(taskFromBinary(*cached[c], *decodeArena));
+                    ++res.parse.cachedTasks;
+                } else {
+                    TaskD d = convertTask(std::move(p.task));
+                    if (cache) cache->store(chunkText(chunks[c]), d);
+                    prog.tasks.push_back(std::move(d));
+                }
+                continue;
+            } catch (const std::exception& ex) {
+                error = std::string("Fehler beim Konvertieren IR -> Domain: ") + ex.what();
+            }
+        }
+
+        FailedTask f;
+        f.task = c + 1;
+        f.line = chunks[c].line;
+        f.error = std::move(error);
+        for (const std::string& m : p.diagnostics) f.diagnostics.push_back(parseDiagnostic(m));
+        if (res.error.empty()) res.error = f.error;
+        report.failed.push_back(std::move(f));
+    }
+    report.compiled = prog.tasks.size();
+
+    applyScoringPolicy(prog, options);
+    out = std::move(prog);
+    return report.failed.empty();
+}
+
+FileResult compileFileRecovering(const std::string& inputPath, const std::string& outputPath,
+                                 const std::string& reportPath, size_t jobs, const CompilerOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    const auto t0 = Clock::now();
+
+    FileResult res;
+    res.inputPath = inputPath;
+    res.outputPath = outputPath;
+
+    auto finish = [&](bool ok) {
+        res.ok = ok;
+        res.millis = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        return res;
+    };
+
+    std::optional<SourceFile> file;
+    try {
+        file.emplace(inputPath);
+    } catch (const std::exception& ex) {
+        res.error = ex.what();
+        return finish(false);
+    }
+
+    ProgramD progD;
+    RecoverReport report;
+    bool ok;
+    if (options.cacheDir.empty()) {
+        ok = compileRecovering(file->text(), inputPath, jobs, progD, report, res, options);
+    } else {
+        TaskCache cache(options.cacheDir, inputPath);
+        ok = compileRecovering(file->text(), inputPath, jobs, progD, report, res, options, &cache);
+        cache.save(); // best effort
+    }
+    if (report.tasks == 0) {
+        res.error = "Eingabedatei ist leer: " + inputPath;
+        ok = false;
+    } else if (!ok) {
+        res.error = std::to_string(report.failed.size()) + " von " + std::to_string(report.tasks) +
+                    " Aufgaben fehlerhaft, erste: " + res.error;
+    }
+
+    try {
+        writeDomainOutput(progD, outputPath, options.format);
+    } catch (const std::exception& ex) {
+        res.error = std::string("Fehler beim Schreiben der ") + outputLabel(options.format) + ": " + ex.what();
+        return finish(false);
+    }
+    if (!ok && report.tasks > 0) res.error += " (Teilergebnis: " + outputPath + ")";
+
+    const bool toStdout = reportPath == "-";
+    std::FILE* f = toStdout ? stdout : std::fopen(reportPath.c_str(), "wb");
+    if (!f) {
+        res.error = "Konnte Diagnosedatei nicht öffnen: " + reportPath;
+        return finish(false);
+    }
+    try {
+        JsonSink sink(f, JsonStyle::Compact);
+        writeRecoverReport(sink, res, report);
+        sink.flush();
+    } catch (const std::exception& ex) {
+        res.error = std::string("Fehler beim Schreiben der Diagnosedatei: ") + ex.what();
+        ok = false;
+    }
+    if (!toStdout && std::fclose(f) != 0) {
+        res.error = "Fehler beim Schreiben der Diagnosedatei: " + reportPath;
+        ok = false;
+    }
+    return finish(ok);
+}
+
+void writeRecoverReport(JsonSink& out, const FileResult& res, const RecoverReport& report) {
+    out << "{\"file\": ";
+    out.string(res.inputPath);
+    out << ", \"output\": ";
+    out.string(res.outputPath);
+    out << ", \"tasks\": " << static_cast<int>(report.tasks)
+        << ", \"compiled\": " << static_cast<int>(report.compiled) << ", \"failed\": [";
+    for (size_t i = 0; i < report.failed.size(); ++i) {
+        const FailedTask& f = report.failed[i];
+        if (i) out << ", ";
+        out << "{\"task\": " << static_cast<int>(f.task) << ", \"line\": " << static_cast<int>(f.line)
+            << ", \"error\": ";
+        out.string(f.error);
+        out << ", \"diagnostics\": [";
+        for (size_t k = 0; k < f.diagnostics.size(); ++k) {
+            const TaskDiagnostic& d = f.diagnostics[k];
+            if (k) out << ", ";
+            out << "{\"line\": " << static_cast<int>(d.line) << ", \"column\": " << static_cast<int>(d.column)
+                << ", \"message\": ";
+            out.string(d.message);
+            out << ", \"expected\": [";
+            for (size_t e = 0; e < d.expected.size(); ++e) {
+                if (e) out << ", ";
+                out.string(d.expected[e]);
+            }
+            out << "]}";
+        }
+        out << "]}";
+    }
+    out << "]}\n";
+}
@@ -0,0 +1,59 @@
+// ============================================================================
+// File: src/driver/Recover.h
+// --recover: compile every clean task of a bank, report the broken ones
+// ============================================================================
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "driver/Compiler.h"
+
+class JsonSink;
+class TaskCache;
+
+// One syntax error, split out of DiagnosticListener's "line L:C msg" text
+struct TaskDiagnostic {
+    size_t line = 0;
+    size_t column = 0;
+    std::string message;
+    std::vector<std::string> expected; // from "expecting {...}" / "missing X at"; may be empty
+};
+
+struct FailedTask {
+    size_t task = 0; // 1-based position of the task in the file
+    size_t line = 0; // first line of the task
+    std::string error;
+    std::vector<TaskDiagnostic> diagnostics;
+};
+
+struct RecoverReport {
+    size_t tasks = 0;    // tasks found by splitTaskUnits
+    size_t compiled = 0; // tasks in the partial program
+    std::vector<FailedTask> failed;
+};
+
+// Cuts `input` with splitTaskUnits and compiles every task on its own (on
+// `jobs` threads, 0 = hardware concurrency). Clean tasks go into `out` in
+// source order, broken ones into `report` - one bad task no longer costs the
+// whole file. `res.diagnostics` gets every message in source order. Returns
+// true if no task failed; `out` holds the partial program either way.
+bool compileRecovering(std::string_view input, const std::string& sourceName, size_t jobs,
+                       ProgramD& out, RecoverReport& report, FileResult& res,
+                       const CompilerOptions& options = {}, TaskCache* cache = nullptr);
+
+// read -> compileRecovering -> write the partial program to `outputPath` (also
+// when tasks failed) and the report as one JSON line to `reportPath` ("-" =
+// stdout). res.ok is false if any task failed or a file could not be written.
+FileResult compileFileRecovering(const std::string& inputPath, const std::string& outputPath,
+                                 const std::string& reportPath, size_t jobs,
+                                 const CompilerOptions& options = {});
+
+TaskDiagnostic parseDiagnostic(const std::string& message);
+
+// {"file": ..., "output": ..., "tasks": 100, "compiled": 59, "failed": [
+//   {"task": 1, "line": 1, "error": ..., "diagnostics": [
+//     {"line": 2, "column": 4, "message": ..., "expected": ["<EOF>", "NEWLINE"]}]}]}
+void writeRecoverReport(JsonSink& out, const FileResult& res, const RecoverReport& report);
@@ -0,0 +1,434 @@
+// ============================================================================
+// File: src/driver/Server.cpp
+// ============================================================================
+#include "driver/Server.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "driver/Batch.h"
+#include "driver/SourceFile.h"
+#include "driver/TaskCache.h"
+#include "driver/WorkStealingPool.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// One task of every kind. Parsed through ANTLR at startup and after a reset,
+// so the first request that falls back from the native parser finds warm DFAs.
+constexpr std::string_view kWarmUpSource =
+    "Aufgabe 1(L\xC3\xBC" "ckentext):Fuelle die Luecken aus.\n"
+    "    Niklas ist(ein,1) toller Mensch.;\n"
+    "Aufgabe 2(Zuordnung):\n"
+    "    Ordne (Hauptstadt) zu (Land)!(3) -Paris/Frankreich -Berlin/Deutschland -Amsterdam/Niederlande;\n"
+    "Aufgabe 3(RoF):\n"
+    "    Berlin ist die Haupstadt von Deutschland. -Richtig\n"
+    "    Paris ist die Haupstadt von England. -Falsch -> Paris ist die Haupstadt von Frankreich.;\n"
+    "Aufgabe 4(Umordnung):\n"
+    "    Sortiere die Zahlen aufsteigend.(2) -1 -2 -3;\n"
+    "Aufgabe 5(Markierung): Markiere alle Autoren.\n"
+    "    (Stephen King)[1] ist ein Buchautor.;\n"
+    "Aufgabe 6(Textkorrektur): Korrigiere die Rechtschreibfehler im Text.\n"
+    "    Ein Vogel kann (vliegen)[fliegen,2].;\n"
+    "Aufgabe 7(Auswahl):\n"
+    "    Welche St\xC3\xA4" "dte sind in Deutschland? -Berlin(1) -Minden(1) -Paris(-1) -London(-1);";
+
+void putLE32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+uint32_t getLE32(const char* p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= uint32_t(static_cast<uint8_t>(p[i])) << (8 * i);
+    return v;
+}
+
+std::string responseFrame(uint32_t id, ServeStatus status, std::string_view output,
+                          std::string_view diagnostics) {
+    std::string f;
+    f.reserve(13 + output.size() + diagnostics.size());
+    putLE32(f, static_cast<uint32_t>(9 + output.size() + diagnostics.size()));
+    putLE32(f, id);
+    f.push_back(static_cast<char>(status));
+    putLE32(f, static_cast<uint32_t>(output.size()));
+    f.append(output);
+    f.append(diagnostics);
+    return f;
+}
+
+// Byte stream carrying the frames of one client. Responses come from the pool
+// workers and are written as whole frames under writeMutex.
+class Channel {
+public:
+    virtual ~Channel() = default;
+
+    // false on EOF or error
+    virtual bool readExact(char* buf, size_t n) = 0;
+
+    void writeFrame(const std::string& frame) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        writeAll(frame.data(), frame.size()); // a vanished client is noticed by the reader
+    }
+
+protected:
+    virtual bool writeAll(const char* data, size_t n) = 0;
+
+private:
+    std::mutex writeMutex;
+};
+
+class StdioChannel : public Channel {
+public:
+    StdioChannel() {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+
+    bool readExact(char* buf, size_t n) override { return std::fread(buf, 1, n, stdin) == n; }
+
+protected:
+    bool writeAll(const char* data, size_t n) override {
+        return std::fwrite(data, 1, n, stdout) == n && std::fflush(stdout) == 0;
+    }
+};
+
+#ifndef _WIN32
+class SocketChannel : public Channel {
+public:
+    explicit SocketChannel(int fd) : fd(fd) {}
+    ~SocketChannel() override { ::close(fd); }
+
+    bool readExact(char* buf, size_t n) override {
+        while (n > 0) {
+            const ssize_t r = ::read(fd, buf, n);
+            if (r < 0 && errno == EINTR) continue;
+            if (r <= 0) return false;
+            buf += r;
+            n -= static_cast<size_t>(r);
+        }
+        return true;
+    }
+
+    // Ends readExact() with EOF; queued responses can still be written.
+    void stopReading() { ::shutdown(fd, SHUT_RD); }
+
+protected:
+    bool writeAll(const char* data, size_t n) override {
+        while (n > 0) {
+            const ssize_t w = ::write(fd, data, n);
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0) return false;
+            data += w;
+            n -= static_cast<size_t>(w);
+        }
+        return true;
+    }
+
+private:
+    int fd;
+};
+#endif
+
+CompilerOptions withAntlrFrontend(CompilerOptions opts) {
+    opts.frontend = FrontendKind::Antlr;
+    return opts;
+}
+
+class Server {
+public:
+    explicit Server(const ServeOptions& options);
+
+    size_t threads() const { return pool.size(); }
+
+    // Reads frames until EOF, a protocol error or a quit request (returns true).
+    bool serve(const std::shared_ptr<Channel>& ch);
+
+    // Waits for the queued requests, then prints the summary to stderr.
+    void finish(double wallMillis);
+
+private:
+    void compile(Channel& ch, uint32_t id, std::string_view source, size_t worker,
+                 Clock::time_point received);
+    void reset();
+    void warmUp();
+
+    ServeOptions opts;
+    std::vector<std::unique_ptr<Compiler>> compilers; // one per pool worker
+    Compiler warm;                                    // ANTLR frontend: warm-up, DFA reset
+    TaskCache cache;                                  // memory only, LRU, shared by all workers
+    std::shared_mutex resetMutex;                     // compiles shared, reset exclusive
+
+    std::mutex statsMutex;
+    std::vector<double> millis; // compile requests: frame read -> response written
+    size_t ok = 0;
+    size_t failed = 0;
+    size_t resets = 0;
+
+    WorkStealingPool pool; // declared last: its workers use all of the above
+};
+
+Server::Server(const ServeOptions& options)
+    : opts(options), warm(withAntlrFrontend(options.compiler)), cache(options.cacheBytes),
+      pool(options.jobs ? options.jobs : std::max(1u, std::thread::hardware_concurrency())) {
+    compilers.resize(pool.size());
+    for (auto& c : compilers) c = std::make_unique<Compiler>(opts.compiler);
+    warmUp();
+}
+
+void Server::warmUp() {
+    ProgramD prog;
+    FileResult res;
+    if (!warm.compile(kWarmUpSource, "warm-up", prog, res)) {
+        std::cerr << "[serve] Warm-up fehlgeschlagen: " << res.error << "\n";
+    }
+}
+
+// Waits for the running compiles; requests queued behind the reset see the empty caches.
+void Server::reset() {
+    std::unique_lock<std::shared_mutex> lock(resetMutex);
+    cache.clear();
+    warm.clearDfaCache();
+    warmUp();
+}
+
+bool Server::serve(const std::shared_ptr<Channel>& ch) {
+    for (;;) {
+        char head[4];
+        if (!ch->readExact(head, sizeof(head))) return false;
+        const uint32_t length = getLE32(head);
+        if (length < 5 || length > kServeMaxFrameBytes) {
+            std::cerr << "[serve] Ungültige Rahmenlänge " << length << ", Verbindung wird geschlossen\n";
+            return false;
+        }
+        std::string frame(length, '\0');
+        if (!ch->readExact(frame.data(), length)) return false;
+
+        const auto received = Clock::now();
+        const uint32_t id = getLE32(frame.data());
+        const auto op = static_cast<ServeOp>(frame[4]);
+
+        switch (op) {
+        case ServeOp::Compile:
+            pool.submit([this, ch, id, received, frame = std::move(frame)](size_t worker) {
+                compile(*ch, id, std::string_view(frame).substr(5), worker, received);
+            });
+            break;
+        case ServeOp::Reset:
+            reset();
+            {
+                std::lock_guard<std::mutex> lock(statsMutex);
+                ++resets;
+            }
+            ch->writeFrame(responseFrame(id, ServeStatus::Ok, {}, {}));
+            break;
+        case ServeOp::Quit:
+            ch->writeFrame(responseFrame(id, ServeStatus::Ok, {}, {}));
+            return true;
+        default:
+            ch->writeFrame(responseFrame(id, ServeStatus::BadRequest, {},
+                                         "Unbekannte Anfrage: op=" +
+                                             std::to_string(static_cast<unsigned>(op)) + "\n"));
+            break;
+        }
+    }
+}
+
+void Server::compile(Channel& ch, uint32_t id, std::string_view source, size_t worker,
+                     Clock::time_point received) {
+    ServeStatus status = ServeStatus::Ok;
+    std::string output;
+    FileResult res;
+    try {
+        std::shared_lock<std::shared_mutex> lock(resetMutex);
+
+        std::string storage;
+        SourceEncoding enc;
+        const std::string_view text = decodeSource(source, storage, enc);
+
+        ProgramD prog;
+        if (text.empty()) {
+            status = ServeStatus::BadRequest;
+            res.error = "Leere Anfrage";
+        } else if (!compilers[worker]->compileCached(text, "request:" + std::to_string(id), cache, prog, res)) {
+            status = ServeStatus::CompileError;
+        } else {
+            try {
+                output = renderDomainOutput(prog, opts.compiler.format);
+            } catch (const std::exception& ex) {
+                status = ServeStatus::CompileError;
+                res.error = std::string("Fehler beim Schreiben der ") + outputLabel(opts.compiler.format) +
+                            ": " + ex.what();
+            }
+        }
+    } catch (const std::exception& ex) {
+        status = ServeStatus::CompileError;
+        output.clear();
+        res.error = ex.what();
+    }
+
+    std::string diagnostics;
+    for (const auto& d : res.diagnostics) diagnostics.append(d).push_back('\n');
+    if (!res.error.empty()) diagnostics.append(res.error).push_back('\n');
+
+    ch.writeFrame(responseFrame(id, status, output, diagnostics));
+
+    const double ms = std::chrono::duration<double, std::milli>(Clock::now() - received).count();
+    std::lock_guard<std::mutex> lock(statsMutex);
+    millis.push_back(ms);
+    ++(status == ServeStatus::Ok ? ok : failed);
+}
+
+void Server::finish(double wallMillis) {
+    pool.wait();
+
+    ParseStats parse;
+    for (const auto& c : compilers) parse += c->stats();
+
+    double sum = 0.0;
+    for (double t : millis) sum += t;
+    const double mean = millis.empty() ? 0.0 : sum / millis.size();
+
+    char line[160];
+    std::cerr << "\n=== SERVE SUMMARY ===\n"
+              << "requests=" << millis.size() << ", ok=" << ok << ", fail=" << failed
+              << ", resets=" << resets << ", cache_entries=" << cache.size()
+              << ", cache_evictions=" << cache.evictions() << "\n";
+    std::snprintf(line, sizeof(line), "mean_ms=%.3f  p50_ms=%.3f  p95_ms=%.3f  p99_ms=%.3f\n", mean,
+                  percentile(millis, 0.50), percentile(millis, 0.95), percentile(millis, 0.99));
+    std::cerr << line;
+    std::cerr << "parse: native=" << parse.nativeParses << ", sll=" << parse.sllParses
+              << ", ll_fallback=" << parse.llFallbacks << ", cached=" << parse.cachedTasks << "\n";
+    std::snprintf(line, sizeof(line), "uptime_ms=%.1f\n", wallMillis);
+    std::cerr << line;
+}
+
+#ifndef _WIN32
+// Accept loop; every connection gets a reader thread, a quit request on any
+// of them wakes the loop through the pipe.
+int serveSocket(Server& server, const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket-Pfad zu lang: " << path << "\n";
+        return 1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    // left behind by a killed server; anything else at `path` makes bind() fail
+    struct stat st;
+    if (::lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) ::unlink(path.c_str());
+
+    const int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    int wake[2] = {-1, -1};
+    if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listenFd, 16) != 0 || ::pipe(wake) != 0) {
+        std::cerr << "Konnte Socket nicht öffnen: " << path << " (" << std::strerror(errno) << ")\n";
+        if (listenFd >= 0) ::close(listenFd);
+        return 1;
+    }
+    std::cerr << "[serve] bereit: " << path << " (" << server.threads() << " Threads)\n";
+
+    struct Connection {
+        std::shared_ptr<SocketChannel> channel;
+        std::atomic<bool> done{false};
+        std::thread reader;
+    };
+    std::vector<std::unique_ptr<Connection>> connections;
+
+    for (;;) {
+        pollfd fds[2] = {{listenFd, POLLIN, 0}, {wake[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        const int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) continue;
+
+        // join readers of closed connections
+        connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                         [](const std::unique_ptr<Connection>& c) {
+                                             if (!c->done) return false;
+                                             c->reader.join();
+                                             return true;
+                                         }),
+                          connections.end());
+
+        auto& c = *connections.emplace_back(std::make_unique<Connection>());
+        c.channel = std::make_shared<SocketChannel>(fd);
+        c.reader = std::thread([&server, &c, wakeFd = wake[1]] {
+            if (server.serve(c.channel)) {
+                const char q = 'q';
+                [[maybe_unused]] const ssize_t w = ::write(wakeFd, &q, 1);
+            }
+            c.done = true;
+        });
+    }
+
+    for (auto& c : connections) c->channel->stopReading();
+    for (auto& c : connections) c->reader.join();
+    ::close(listenFd);
+    ::close(wake[0]);
+    ::close(wake[1]);
+    ::unlink(path.c_str());
+    return 0;
+}
+#endif
+
+} // namespace
+
+int runServe(const ServeOptions& opts) {
+#ifdef _WIN32
+    if (!opts.socketPath.empty()) {
+        std::cerr << "--socket wird unter Windows nicht unterstützt (stdin/stdout verwenden).\n";
+        return 1;
+    }
+#else
+    std::signal(SIGPIPE, SIG_IGN); // a client that went away must not end the server
+#endif
+
+    const auto t0 = Clock::now();
+    Server server(opts);
+
+    int rc = 0;
+    if (opts.socketPath.empty()) {
+        std::cerr << "[serve] bereit: stdin/stdout (" << server.threads() << " Threads)\n";
+        server.serve(std::make_shared<StdioChannel>());
+    } else {
+#ifndef _WIN32
+        rc = serveSocket(server, opts.socketPath);
+#endif
+    }
+
+    if (rc == 0) server.finish(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    return rc;
+}
@@ -0,0 +1,51 @@
+// ============================================================================
+// File: src/driver/Server.h
+// --serve: long-running compile server over stdin/stdout or a Unix socket
+// ============================================================================
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "driver/Compiler.h"
+
+// Frames are little-endian and length-prefixed, so payloads are raw bytes:
+//
+//   request:  u32 length | u32 id | u8 op | payload
+//   response: u32 length | u32 id | u8 status | u32 outputLength | output | diagnostics
+//
+// `length` counts the bytes after itself. The response echoes the request id;
+// requests run concurrently, so responses can arrive out of order.
+//
+//   op 'C'  compile: payload = DSL source (UTF-8 or Windows-1252, BOM allowed),
+//           output = JSON/binary in --format, only on success
+//   op 'R'  reset: empties the task cache and the parser's DFA cache
+//           (the task cache also evicts on its own, see ServeOptions::cacheBytes)
+//   op 'Q'  quit: stops reading, answers the queued requests, exits
+//
+// diagnostics = UTF-8 lines (syntax errors, then the error message), may be empty.
+enum class ServeOp : uint8_t {
+    Compile = 'C',
+    Reset = 'R',
+    Quit = 'Q'
+};
+
+enum class ServeStatus : uint8_t {
+    Ok = 0,
+    CompileError = 1, // syntax/conversion error, see diagnostics
+    BadRequest = 2    // unknown op or empty source
+};
+
+// Frames above this size close the connection (garbage instead of a length).
+constexpr uint32_t kServeMaxFrameBytes = 256u * 1024 * 1024;
+
+struct ServeOptions {
+    size_t jobs = 0;        // worker threads; 0 = hardware concurrency
+    std::string socketPath; // empty = stdin/stdout; otherwise AF_UNIX (not on Windows)
+    size_t cacheBytes = 64u * 1024 * 1024; // task cache budget (LRU); 0 = unbounded
+    CompilerOptions compiler;
+};
+
+// Serves until EOF on stdin (resp. a quit request on any connection), then
+// prints a latency summary to stderr. Returns the process exit code.
+int runServe(const ServeOptions& opts);
@@ -0,0 +1,196 @@
+// ============================================================================
+// File: src/driver/SourceFile.cpp
+// ============================================================================
+#include "driver/SourceFile.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const char* encodingName(SourceEncoding enc) {
+    switch (enc) {
+    case SourceEncoding::Utf8:        return "UTF-8";
+    case SourceEncoding::Utf8Bom:     return "UTF-8 (BOM)";
+    case SourceEncoding::Windows1252: return "Windows-1252";
+    }
+    return "?";
+}
+
+// -------------------------
+// Encoding detection
+// -------------------------
+
+// Strict UTF-8 check (no overlongs, no surrogates, <= U+10FFFF); ASCII runs
+// are skipped 8 bytes at a time.
+static bool isValidUtf8(std::string_view s) {
+    const auto* p = reinterpret_cast<const unsigned char*>(s.data());
+    const size_t n = s.size();
+    size_t i = 0;
+    while (i < n) {
+        if (i + 8 <= n) {
+            uint64_t chunk;
+            std::memcpy(&chunk, p + i, 8);
+            if ((chunk & 0x8080808080808080ull) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+        const unsigned char c = p[i];
+        if (c < 0x80) {
+            ++i;
+            continue;
+        }
+
+        size_t len;
+        unsigned char lo = 0x80, hi = 0xBF; // allowed range of the 2nd byte
+        if (c >= 0xC2 && c <= 0xDF) len = 2;
+        else if (c == 0xE0) { len = 3; lo = 0xA0; }
+        else if (c >= 0xE1 && c <= 0xEC) len = 3;
+        else if (c == 0xED) { len = 3; hi = 0x9F; }
+        else if (c >= 0xEE && c <= 0xEF) len = 3;
+        else if (c == 0xF0) { len = 4; lo = 0x90; }
+        else if (c >= 0xF1 && c <= 0xF3) len = 4;
+        else if (c == 0xF4) { len = 4; hi = 0x8F; }
+        else return false;
+
+        if (i + len > n) return false;
+        if (p[i + 1] < lo || p[i + 1] > hi) return false;
+        for (size_t k = 2; k < len; ++k) {
+            if ((p[i + k] & 0xC0) != 0x80) return false;
+        }
+        i += len;
+    }
+    return true;
+}
+
+// Windows-1252 0x80..0x9F; the five unassigned bytes map to the C1 controls
+static const uint16_t kCp1252High[32] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+};
+
+static void transcodeCp1252(std::string_view in, std::string& out) {
+    out.clear();
+    out.reserve(in.size() + in.size() / 8);
+    for (char ch : in) {
+        const unsigned char c = static_cast<unsigned char>(ch);
+        if (c < 0x80) {
+            out.push_back(ch);
+            continue;
+        }
+        const uint32_t cp = c < 0xA0 ? kCp1252High[c - 0x80] : c;
+        if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+}
+
+std::string_view decodeSource(std::string_view raw, std::string& storage, SourceEncoding& enc) {
+    if (raw.size() >= 3 && raw.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+        enc = SourceEncoding::Utf8Bom;
+        raw.remove_prefix(3);
+        return raw; // invalid bytes after a BOM are left to the lexer's error reporting
+    }
+    if (isValidUtf8(raw)) {
+        enc = SourceEncoding::Utf8;
+        return raw;
+    }
+    enc = SourceEncoding::Windows1252;
+    transcodeCp1252(raw, storage);
+    return storage;
+}
+
+// -------------------------
+// SourceFile
+// -------------------------
+static std::runtime_error cannotOpen(const std::string& path) {
+    return std::runtime_error("Konnte Eingabedatei nicht öffnen: " + path);
+}
+
+SourceFile::SourceFile(const std::string& path, bool map) {
+    if (map) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw cannotOpen(path);
+        LARGE_INTEGER size{};
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                mapData = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                if (mapData) mapSize = static_cast<size_t>(size.QuadPart);
+                CloseHandle(mapping); // the view keeps the mapping alive
+            }
+        }
+        CloseHandle(file);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw cannotOpen(path);
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                mapData = static_cast<const char*>(p);
+                mapSize = static_cast<size_t>(st.st_size);
+                ::madvise(p, mapSize, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    std::string_view raw(mapData, mapSize);
+    if (!mapData) {
+        // empty file, pipe, mapping refused or not wanted: plain read
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw cannotOpen(path);
+        std::ostringstream buffer;
+        buffer << in.rdbuf();
+        owned = buffer.str();
+        raw = owned;
+    }
+
+    std::string transcoded;
+    view = decodeSource(raw, transcoded, enc);
+    if (enc == SourceEncoding::Windows1252) {
+        owned = std::move(transcoded);
+        view = owned;
+        unmap(); // only the transcoded copy is used from here on
+    }
+}
+
+SourceFile::~SourceFile() {
+    unmap();
+}
+
+void SourceFile::unmap() {
+    if (!mapData) return;
+#ifdef _WIN32
+    UnmapViewOfFile(mapData);
+#else
+    ::munmap(const_cast<char*>(mapData), mapSize);
+#endif
+    mapData = nullptr;
+    mapSize = 0;
+}
@@ -0,0 +1,51 @@
+// ============================================================================
+// File: src/driver/SourceFile.h
+// Memory-mapped input file with BOM / UTF-8 / Windows-1252 detection
+// ============================================================================
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+enum class SourceEncoding {
+    Utf8,       // valid UTF-8 (incl. pure ASCII), used in place
+    Utf8Bom,    // UTF-8 with BOM, view starts after the BOM
+    Windows1252 // not valid UTF-8: transcoded once into an owned buffer
+};
+
+const char* encodingName(SourceEncoding enc);
+
+// Returns the UTF-8 text of `raw`: a view into `raw` for UTF-8 (BOM skipped),
+// otherwise `raw` is transcoded from Windows-1252 into `storage` and the view
+// points there.
+std::string_view decodeSource(std::string_view raw, std::string& storage, SourceEncoding& enc);
+
+// The single copy of an input file for the whole pipeline: the lexer tokens,
+// NativeParser and IRBuilder all hold views into text(). The file is mapped
+// read-only (plain read as fallback), so UTF-8 input is never copied.
+// With `map` false the file is always read into an owned buffer: a mapping
+// faults (SIGBUS) if another process truncates the file while it is parsed.
+// Not copyable/movable: views must not outlive it.
+class SourceFile {
+public:
+    // Throws std::runtime_error("Konnte Eingabedatei nicht öffnen: ...")
+    explicit SourceFile(const std::string& path, bool map = true);
+    ~SourceFile();
+
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+
+    std::string_view text() const { return view; }
+    SourceEncoding encoding() const { return enc; }
+    bool mapped() const { return mapData != nullptr; }
+
+private:
+    void unmap();
+
+    const char* mapData = nullptr;
+    size_t mapSize = 0;
+    std::string owned; // read fallback or transcoded text
+    std::string_view view;
+    SourceEncoding enc = SourceEncoding::Utf8;
+};
@@ -0,0 +1,285 @@
+// ============================================================================
+// File: src/driver/SplitCompile.cpp
+// ============================================================================
+#include "driver/SplitCompile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "domain/DomainBinary.h"
+#include "domain/DomainConvert.h"
+#include "domain/DomainOutput.h"
+#include "driver/SourceFile.h"
+#include "driver/TaskCache.h"
+#include "driver/WorkStealingPool.h"
+
+static bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+bool splitTasks(std::string_view src, std::vector<TaskChunk>& out) {
+    out.clear();
+
+    const size_t n = src.size();
+    size_t line = 1;
+
+    // leading WS is skipped by the lexer, a leading NEWLINE is a syntax error
+    size_t i = 0;
+    while (i < n && isBlank(src[i])) ++i;
+    if (i < n && (src[i] == '\n' || src[i] == '\r')) return false;
+
+    TaskChunk cur;
+    cur.begin = 0;
+    cur.line = 1;
+
+    for (; i < n; ++i) {
+        const char c = src[i];
+        if (c == '\n') {
+            ++line;
+            continue;
+        }
+        if (c != ';') continue;
+
+        // ';' [ \t]* '\r'? '\n'
+        size_t j = i + 1;
+        while (j < n && isBlank(src[j])) ++j;
+        if (j < n && src[j] == '\r') ++j;
+        if (j >= n || src[j] != '\n') continue;
+
+        cur.end = i + 1;
+        out.push_back(cur);
+
+        ++line;
+        i = j; // on the '\n'
+
+        // exactly one NEWLINE between tasks; a single trailing NEWLINE is fine
+        size_t k = j + 1;
+        while (k < n && isBlank(src[k])) ++k;
+        if (k >= n) return true;
+        if (src[k] == '\n' || src[k] == '\r') return false;
+
+        cur.begin = j + 1;
+        cur.line = line;
+    }
+
+    // last task (no trailing NEWLINE, or no ';' at all -> parse error reported by the chunk)
+    size_t k = cur.begin;
+    while (k < n && isBlank(src[k])) ++k;
+    if (k < n) {
+        cur.end = n;
+        out.push_back(cur);
+    }
+    return true;
+}
+
+void splitTaskUnits(std::string_view src, std::vector<TaskChunk>& out) {
+    out.clear();
+
+    TaskChunk cur;
+    bool open = false;
+    size_t line = 1;
+    for (size_t pos = 0; pos < src.size(); ++line) {
+        const size_t eol = src.find('\n', pos);
+        const size_t next = eol == std::string_view::npos ? src.size() : eol + 1;
+
+        size_t last = next;
+        while (last > pos && (isBlank(src[last - 1]) || src[last - 1] == '\r' || src[last - 1] == '\n')) --last;
+        if (last == pos) {
+            if (open) out.push_back(cur);
+            open = false;
+        } else {
+            if (!open) {
+                cur.begin = pos;
+                cur.line = line;
+                open = true;
+            }
+            cur.end = last;
+            if (src[last - 1] == ';') {
+                out.push_back(cur);
+                open = false;
+            }
+        }
+        pos = next;
+    }
+    if (open) out.push_back(cur);
+}
+
+Arenas compileChunks(std::string_view input, const std::vector<TaskChunk>& chunks,
+                     const std::vector<bool>& skip, const std::string& sourceName, size_t jobs,
+                     const CompilerOptions& options, std::vector<ChunkResult>& parts, ParseStats& stats) {
+    if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+    parts.resize(chunks.size());
+
+    // Group neighbouring tasks to amortise lexer/parser re-seating for banks of
+    // tiny tasks, but keep ~4 jobs per thread so typical banks still spread out.
+    size_t parsedBytes = 0;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        if (!skip[c]) parsedBytes += chunks[c].end - chunks[c].begin;
+    }
+    const size_t minJobBytes = std::max<size_t>(4 * 1024, parsedBytes / (jobs * 4));
+    std::vector<std::pair<size_t, size_t>> groups; // [first, last) chunk indices
+    for (size_t first = 0; first < chunks.size();) {
+        size_t last = first;
+        size_t bytes = 0;
+        while (last < chunks.size() && (bytes < minJobBytes || last == first)) {
+            if (!skip[last]) bytes += chunks[last].end - chunks[last].begin;
+            ++last;
+        }
+        groups.emplace_back(first, last);
+        first = last;
+    }
+    jobs = std::max<size_t>(1, std::min(jobs, groups.size()));
+
+    Arenas arenas(groups.size()); // one arena per job, handed to the merged program
+    std::vector<std::unique_ptr<Compiler>> compilers(jobs);
+    WorkStealingPool pool(jobs);
+    for (size_t gi = 0; gi < groups.size(); ++gi) {
+        pool.submit([&, gi](size_t worker) {
+            if (!compilers[worker]) compilers[worker] = std::make_unique<Compiler>(options);
+            const auto& g = groups[gi];
+            arenas[gi] = std::make_shared<Arena>();
+            for (size_t c = g.first; c < g.second; ++c) {
+                if (skip[c]) continue;
+                const TaskChunk& ch = chunks[c];
+                parts[c].ok = compilers[worker]->compileTask(
+                    input.substr(ch.begin, ch.end - ch.begin), sourceName, ch.line, *arenas[gi], parts[c].task,
+                    parts[c].diagnostics, parts[c].error);
+            }
+        });
+    }
+    pool.wait();
+
+    for (const auto& c : compilers) {
+        if (c) stats += c->stats();
+    }
+    return arenas;
+}
+
+bool compileSplit(std::string_view input, const std::string& sourceName, size_t jobs,
+                  ProgramD& out, FileResult& res, const CompilerOptions& options, TaskCache* cache) {
+    if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<TaskChunk> chunks;
+    if (jobs <= 1 || !splitTasks(input, chunks) || chunks.size() < 2) {
+        Compiler compiler(options);
+        const bool ok = cache ? compiler.compileCached(input, sourceName, *cache, out, res)
+                              : compiler.compile(input, sourceName, out, res);
+        res.parse += compiler.stats();
+        return ok;
+    }
+
+    auto chunkText = [&](const TaskChunk& ch) {
+        return std::string_view(input.data() + ch.begin, ch.end - ch.begin);
+    };
+
+    // cache hits are decoded during the merge and never reach the pool
+    std::vector<std::shared_ptr<const std::string>> cached(chunks.size());
+    if (cache) {
+        for (size_t c = 0; c < chunks.size(); ++c) cached[c] = cache->find(chunkText(chunks[c]));
+    }
+
+    std::vector<bool> skip(chunks.size());
+    for (size_t c = 0; c < chunks.size(); ++c) skip[c] = cached[c] != nullptr;
+    std::vector<ChunkResult> parts(chunks.size());
+    Arenas arenas = compileChunks(input, chunks, skip, sourceName, jobs, options, parts, res.parse);
+
+    // merge in source order
+    ProgramD prog;
+    prog.arenas = std::move(arenas);
+    prog.tasks.reserve(chunks.size());
+    Arena* decodeArena = nullptr; // created on the first cache hit
+    bool ok = true;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        auto& p = parts[c];
+        try {
+            if (cached[c]) {
+                if (!decodeArena) decodeArena = prog.arenas.emplace_back(std::make_shared<Arena>()).get();
+                if (ok) prog.tasks.push_back(taskFromBinary(*cached[c], *decodeArena));
+                ++res.parse.cachedTasks;
+                continue;
+            }
+
+            res.diagnostics.insert(res.diagnostics.end(), p.diagnostics.begin(), p.diagnostics.end());
+            if (!p.ok) {
+                if (ok) res.error = p.error;
+                ok = false;
+                continue;
+            }
+
+            TaskD d = convertTask(std::move(p.task));
+            if (cache) cache->store(chunkText(chunks[c]), d);
+            if (ok) prog.tasks.push_back(std::move(d));
+        } catch (const std::exception& ex) {
+            if (ok) res.error = std::string("Fehler beim Konvertieren IR -> Domain: ") + ex.what();
+            ok = false;
+        }
+    }
+    if (!ok) {
+        // Per-chunk diagnostics can differ from the whole-file ones (e.g. '<EOF>'
+        // instead of the next task's first token); re-parse so they stay identical.
+        std::string chunkError = std::move(res.error);
+        res.error.clear();
+        res.diagnostics.clear();
+        Compiler compiler(options);
+        ProgramD whole;
+        compiler.compile(input, sourceName, whole, res);
+        res.parse += compiler.stats();
+        if (res.error.empty()) res.error = std::move(chunkError);
+        return false;
+    }
+
+    applyScoringPolicy(prog, options);
+    out = std::move(prog);
+    return true;
+}
+
+FileResult compileFileSplit(const std::string& inputPath, const std::string& outputPath, size_t jobs,
+                            const CompilerOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    const auto t0 = Clock::now();
+
+    FileResult res;
+    res.inputPath = inputPath;
+    res.outputPath = outputPath;
+
+    auto finish = [&](bool ok) {
+        res.ok = ok;
+        res.millis = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        return res;
+    };
+
+    std::optional<SourceFile> file;
+    try {
+        file.emplace(inputPath);
+    } catch (const std::exception& ex) {
+        res.error = ex.what();
+        return finish(false);
+    }
+    const std::string_view input = file->text();
+
+    if (input.empty()) {
+        res.error = "Eingabedatei ist leer: " + inputPath;
+        return finish(false);
+    }
+
+    ProgramD progD;
+    if (options.cacheDir.empty()) {
+        if (!compileSplit(input, inputPath, jobs, progD, res, options)) return finish(false);
+    } else {
+        TaskCache cache(options.cacheDir, inputPath);
+        const bool ok = compileSplit(input, inputPath, jobs, progD, res, options, &cache);
+        cache.save(); // best effort, also keeps the valid tasks of a failed compile
+        if (!ok) return finish(false);
+    }
+
+    try {
+        writeDomainOutput(progD, outputPath, options.format);
+    } catch (const std::exception& ex) {
+        res.error = std::string("Fehler beim Schreiben der ") + outputLabel(options.format) + ": " + ex.what();
+        return finish(false);
+    }
+
+    return finish(true);
+}
@@ -0,0 +1,59 @@
+// ============================================================================
+// File: src/driver/SplitCompile.h
+// Intra-file parallelism: cut a program at ';' NEWLINE and parse tasks concurrently
+// ============================================================================
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "driver/Compiler.h"
+
+struct TaskChunk {
+    size_t begin = 0; // byte offset of the task text (after the separating NEWLINE)
+    size_t end = 0;   // one past the terminating ';'
+    size_t line = 1;  // line of `begin` in the original file
+};
+
+// Cheap pre-scan for task boundaries. ';' is always a literal token (CONNECTION
+// never wins against it), so "';' [ \t]* NEWLINE" can only end a task_definition.
+// Returns false when the separators do not match `tasks NEWLINE? EOF` exactly
+// (blank lines between tasks, leading NEWLINE, ...) - the caller then parses the
+// whole file so the diagnostics stay identical to the sequential run.
+bool splitTasks(std::string_view src, std::vector<TaskChunk>& out);
+
+// Lenient cut for question banks (--recover): a task ends at a line whose
+// last non-blank character is ';' or at a blank line. Never fails; blank lines
+// are dropped, every other line lands in exactly one chunk, so a broken task
+// cannot swallow its neighbours.
+void splitTaskUnits(std::string_view src, std::vector<TaskChunk>& out);
+
+// Outcome of compiling one chunk on its own (Compiler::compileTask)
+struct ChunkResult {
+    bool ok = false;
+    TaskIR task;
+    std::vector<std::string> diagnostics;
+    std::string error;
+};
+
+// Parses every chunk with skip[c] == false on `jobs` threads (0 = hardware
+// concurrency) into parts[c]. Neighbouring chunks are grouped into jobs of at
+// least max(4 KiB, parsed bytes / (4 * jobs)); the returned arenas own the
+// strings of all parts.
+Arenas compileChunks(std::string_view input, const std::vector<TaskChunk>& chunks,
+                     const std::vector<bool>& skip, const std::string& sourceName, size_t jobs,
+                     const CompilerOptions& options, std::vector<ChunkResult>& parts, ParseStats& stats);
+
+// Parses every chunk on `jobs` threads (0 = hardware concurrency), builds one
+// TaskIR per chunk and merges them in source order. Falls back to Compiler::compile
+// (Compiler::compileCached with a cache) for files that cannot be split or hold a
+// single task. With `cache`, chunks found there are decoded instead of parsed.
+// If a chunk fails, the whole file is parsed once more so the diagnostics are
+// exactly those of the sequential run.
+bool compileSplit(std::string_view input, const std::string& sourceName, size_t jobs,
+                  ProgramD& out, FileResult& res, const CompilerOptions& options = {},
+                  TaskCache* cache = nullptr);
+
+FileResult compileFileSplit(const std::string& inputPath, const std::string& outputPath, size_t jobs,
+                            const CompilerOptions& options = {});
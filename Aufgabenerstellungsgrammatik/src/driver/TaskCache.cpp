@@ -0,0 +1,219 @@
+// ============================================================================
+// File: src/driver/TaskCache.cpp
+// ============================================================================
+#include "driver/TaskCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <utility>
+
+#include "domain/DomainBinary.h"
+
+#ifndef AUFGABEN_DSL_GRAMMAR_SHA256
+#define AUFGABEN_DSL_GRAMMAR_SHA256 "unknown"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::string_view kGrammarId = AUFGABEN_DSL_GRAMMAR_SHA256;
+
+uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+void putLE(std::string& out, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+// Bounds-checked little-endian reads over the loaded file
+struct Cursor {
+    std::string_view data;
+    size_t pos = 0;
+    bool ok = true;
+
+    uint64_t le(int bytes) {
+        if (!ok || data.size() - pos < static_cast<size_t>(bytes)) {
+            ok = false;
+            return 0;
+        }
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) v |= uint64_t(static_cast<uint8_t>(data[pos + i])) << (8 * i);
+        pos += static_cast<size_t>(bytes);
+        return v;
+    }
+    std::string_view bytes(uint64_t n) {
+        if (!ok || data.size() - pos < n) {
+            ok = false;
+            return {};
+        }
+        const std::string_view s = data.substr(pos, static_cast<size_t>(n));
+        pos += static_cast<size_t>(n);
+        return s;
+    }
+};
+
+} // namespace
+
+// 8 bytes per step. Only picks the bucket: entries are verified against their
+// stored text.
+uint64_t TaskCache::hashText(std::string_view text) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ text.size();
+    const char* p = text.data();
+    size_t n = text.size();
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t w;
+        std::memcpy(&w, p, 8);
+        h = mix(h ^ w) + 0x9E3779B97F4A7C15ull;
+    }
+    if (n > 0) {
+        uint64_t w = 0;
+        std::memcpy(&w, p, n);
+        h = mix(h ^ w ^ (uint64_t(n) << 56));
+    }
+    return mix(h);
+}
+
+TaskCache::TaskCache(const std::string& cacheDir, const std::string& inputPath) {
+    std::error_code ec;
+    fs::path input = fs::absolute(inputPath, ec);
+    if (ec) input = inputPath;
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.aufc",
+                  static_cast<unsigned long long>(hashText(input.lexically_normal().generic_string())));
+    path = (fs::path(cacheDir) / name).string();
+    load();
+}
+
+// "AUFC" u32 cacheVersion u32 binaryVersion str grammarId u32 count
+// count * (u64 hash, u64 length, str text, str record)    str = u32 length + bytes
+void TaskCache::load() {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return;
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    const std::string data = buffer.str();
+
+    Cursor c{data};
+    if (c.bytes(4) != "AUFC" || c.le(4) != kTaskCacheVersion || c.le(4) != kDomainBinaryVersion) return;
+    if (c.bytes(c.le(4)) != kGrammarId) return;
+
+    const uint64_t count = c.le(4);
+    for (uint64_t i = 0; i < count && c.ok; ++i) {
+        Key key;
+        key.hash = c.le(8);
+        key.length = c.le(8);
+        const std::string_view text = c.bytes(c.le(4));
+        const std::string_view record = c.bytes(c.le(4));
+        if (!c.ok) break;
+        if (text.size() != key.length || hashText(text) != key.hash) {
+            c.ok = false; // damaged entry: distrust the whole file
+            break;
+        }
+        if (!entries.count(key)) insert(key, text, std::make_shared<const std::string>(record));
+    }
+    if (!c.ok) clear(); // truncated file: start over
+}
+
+std::shared_ptr<const std::string> TaskCache::find(std::string_view taskText) {
+    const Key key{hashText(taskText), taskText.size()};
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end() || it->second.text != taskText) return nullptr;
+    it->second.used = true;
+    lru.splice(lru.begin(), lru, it->second.recent);
+    return it->second.record;
+}
+
+TaskCache::Entry& TaskCache::insert(const Key& key, std::string_view text, std::shared_ptr<const std::string> record) {
+    Entry& e = entries[key];
+    e.text.assign(text.data(), text.size());
+    e.record = std::move(record);
+    lru.push_front(key);
+    e.recent = lru.begin();
+    bytes += e.text.size() + e.record->size();
+    return e;
+}
+
+void TaskCache::evict() {
+    // the newest entry always stays, even if it alone exceeds the budget
+    while (budget != 0 && bytes > budget && lru.size() > 1) {
+        const auto it = entries.find(lru.back());
+        bytes -= it->second.text.size() + it->second.record->size();
+        entries.erase(it);
+        lru.pop_back();
+        ++evicted;
+    }
+}
+
+void TaskCache::store(std::string_view taskText, const TaskD& task) {
+    const Key key{hashText(taskText), taskText.size()};
+    auto record = std::make_shared<const std::string>(taskToBinary(task));
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        insert(key, taskText, std::move(record)).used = true;
+        evict();
+        return;
+    }
+    // on a collision the slot keeps its task; this text just stays uncached
+    if (it->second.text == taskText) {
+        it->second.used = true;
+        lru.splice(lru.begin(), lru, it->second.recent);
+    }
+}
+
+void TaskCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lru.clear();
+    bytes = 0;
+}
+
+bool TaskCache::save() const {
+    if (path.empty()) return true;
+
+    std::string out = "AUFC";
+    putLE(out, kTaskCacheVersion, 4);
+    putLE(out, kDomainBinaryVersion, 4);
+    putLE(out, kGrammarId.size(), 4);
+    out.append(kGrammarId.data(), kGrammarId.size());
+
+    const size_t countAt = out.size();
+    putLE(out, 0, 4);
+    uint32_t count = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (const auto& [key, e] : entries) {
+        if (!e.used) continue;
+        putLE(out, key.hash, 8);
+        putLE(out, key.length, 8);
+        putLE(out, e.text.size(), 4);
+        out += e.text;
+        putLE(out, e.record->size(), 4);
+        out += *e.record;
+        ++count;
+    }
+    lock.unlock();
+    for (int i = 0; i < 4; ++i) out[countAt + i] = static_cast<char>((count >> (8 * i)) & 0xFF);
+
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f.write(out.data(), static_cast<std::streamsize>(out.size()))) return false;
+    }
+    fs::rename(tmp, path, ec);
+    return !ec;
+}
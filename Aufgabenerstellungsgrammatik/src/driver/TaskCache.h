@@ -0,0 +1,94 @@
+// ============================================================================
+// File: src/driver/TaskCache.h
+// Content-addressed per-task cache: task source span -> binary TaskD record
+// ============================================================================
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "domain/Domain.h"
+
+// Bump when the IR a task compiles to changes without a grammar change
+// (IRBuilder/NativeParser output, TaskD layout). Grammar edits are caught by
+// the SHA-256 of the .g4 file baked in at build time.
+constexpr uint32_t kTaskCacheVersion = 2; // 2: entries carry their task text
+
+// One cache file per input (<dir>/<hash of the input path>.aufc). Entries are
+// keyed by the hash and length of a task_definition's source text (as cut by
+// splitTasks) and hold that text plus the task's DomainBinary record; find()
+// compares the text, so a hash collision (accidental or crafted, as in --serve)
+// is a miss, never another task's record. save() keeps only the
+// entries used since load, so the file mirrors the last compile of that input.
+// Best effort: an unreadable/outdated file starts empty, write errors are ignored.
+// With a byte budget (--serve) the least recently used entries are evicted
+// once text + record bytes exceed it; records are shared, so one returned by
+// find() stays valid after eviction. find()/store() may be called from
+// several threads.
+class TaskCache {
+public:
+    // In-memory only (no file), e.g. for --verify. `byteBudget` caps text +
+    // record bytes (LRU eviction); 0 = unbounded.
+    explicit TaskCache(size_t byteBudget = 0) : budget(byteBudget) {}
+
+    // Loads the cache file of `inputPath` in `cacheDir`, if any.
+    TaskCache(const std::string& cacheDir, const std::string& inputPath);
+
+    // Record of a task with exactly this source text, or nullptr.
+    std::shared_ptr<const std::string> find(std::string_view taskText);
+
+    // Keeps the existing record if the text is already cached.
+    void store(std::string_view taskText, const TaskD& task);
+
+    // Drops all entries.
+    void clear();
+
+    // Writes the used entries (temp file + rename); returns false on I/O errors.
+    bool save() const;
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    // Entries dropped to stay within the byte budget since construction
+    size_t evictions() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return evicted;
+    }
+
+    static uint64_t hashText(std::string_view text);
+
+private:
+    struct Key {
+        uint64_t hash;
+        uint64_t length;
+        bool operator==(const Key& o) const { return hash == o.hash && length == o.length; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const { return static_cast<size_t>(k.hash ^ (k.length * 0x9E3779B97F4A7C15ull)); }
+    };
+    struct Entry {
+        std::string text; // the task source the record was compiled from
+        std::shared_ptr<const std::string> record;
+        bool used = false;
+        std::list<Key>::iterator recent; // position in `lru`
+    };
+
+    void load();
+    Entry& insert(const Key& key, std::string_view text, std::shared_ptr<const std::string> record);
+    void evict(); // mutex held
+
+    std::string path; // empty = memory only
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    std::list<Key> lru; // most recently used first
+    size_t budget = 0;  // 0 = unbounded
+    size_t bytes = 0;   // text + record bytes of all entries
+    size_t evicted = 0;
+};
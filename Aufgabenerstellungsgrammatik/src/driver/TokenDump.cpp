@@ -0,0 +1,167 @@
+// ============================================================================
+// File: src/driver/TokenDump.cpp
+// ============================================================================
+#include "driver/TokenDump.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// fwrite with one 64 KiB buffer instead of per-token stream calls
+class DumpSink {
+public:
+    explicit DumpSink(const std::string& path) {
+        if (path == "-") {
+            file = stdout;
+            return;
+        }
+        namespace fs = std::filesystem;
+        fs::path p(path);
+        if (p.has_parent_path()) fs::create_directories(p.parent_path());
+        file = std::fopen(path.c_str(), "wb");
+        owned = true;
+        if (!file) throw std::runtime_error("Could not open token dump file: " + path);
+        this->path = path;
+    }
+
+    // Only closes after an error (exception on the way out); the normal path
+    // calls close(), which reports a failed flush or fclose.
+    ~DumpSink() {
+        if (owned && file) std::fclose(file);
+    }
+
+    void close() {
+        flush();
+        if (!owned) {
+            if (std::fflush(file) != 0) throw std::runtime_error("Could not write token dump to stdout");
+            return;
+        }
+        std::FILE* f = file;
+        file = nullptr;
+        if (std::fclose(f) != 0) throw std::runtime_error("Could not write token dump file: " + path);
+    }
+
+    void put(const char* data, size_t n) {
+        if (buf.size() + n > kCapacity) flush();
+        if (n > kCapacity) {
+            write(data, n);
+            return;
+        }
+        buf.insert(buf.end(), data, data + n);
+    }
+    void put(const std::string& s) { put(s.data(), s.size()); }
+    void put(char c) { put(&c, 1); }
+
+    void putU16(uint16_t v) {
+        char b[2] = {static_cast<char>(v & 0xFF), static_cast<char>(v >> 8)};
+        put(b, 2);
+    }
+    void putU32(uint32_t v) {
+        char b[4];
+        for (int i = 0; i < 4; ++i) b[i] = static_cast<char>((v >> (8 * i)) & 0xFF);
+        put(b, 4);
+    }
+    void putNum(size_t v) { put(std::to_string(v)); }
+
+    void flush() {
+        if (!buf.empty()) write(buf.data(), buf.size());
+        buf.clear();
+    }
+
+private:
+    void write(const char* data, size_t n) {
+        if (std::fwrite(data, 1, n, file) != n) {
+            throw std::runtime_error("Could not write token dump file: " + (owned ? path : std::string("-")));
+        }
+    }
+
+    static constexpr size_t kCapacity = 64 * 1024;
+    std::FILE* file = nullptr;
+    bool owned = false;
+    std::string path;
+    std::vector<char> buf;
+};
+
+void putJsonString(DumpSink& out, const std::string& s) {
+    static const char* hex = "0123456789abcdef";
+    out.put('"');
+    for (unsigned char c : s) {
+        switch (c) {
+        case '\"': out.put("\\\"", 2); break;
+        case '\\': out.put("\\\\", 2); break;
+        case '\n': out.put("\\n", 2);  break;
+        case '\r': out.put("\\r", 2);  break;
+        case '\t': out.put("\\t", 2);  break;
+        default:
+            if (c < 0x20) {
+                char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out.put(esc, 6);
+            } else {
+                out.put(static_cast<char>(c));
+            }
+        }
+    }
+    out.put('"');
+}
+
+bool endsWith(const std::string& s, const char* suffix) {
+    const std::string suf(suffix);
+    return s.size() >= suf.size() && s.compare(s.size() - suf.size(), suf.size(), suf) == 0;
+}
+
+} // namespace
+
+void dumpTokens(antlr4::CommonTokenStream& tokens, const antlr4::dfa::Vocabulary& vocab,
+                const std::string& path) {
+    tokens.fill();
+    const auto all = tokens.getTokens();
+
+    DumpSink out(path);
+
+    if (endsWith(path, ".bin")) {
+        out.put("AUFT", 4);
+        out.putU32(1);
+        out.putU32(static_cast<uint32_t>(all.size()));
+        for (auto* t : all) {
+            const std::string txt = t->getText();
+            out.putU16(static_cast<uint16_t>(t->getType()));
+            out.putU32(static_cast<uint32_t>(t->getLine()));
+            out.putU32(static_cast<uint32_t>(t->getCharPositionInLine()));
+            out.putU32(static_cast<uint32_t>(t->getStartIndex()));
+            out.putU32(static_cast<uint32_t>(t->getStopIndex()));
+            out.putU32(static_cast<uint32_t>(txt.size()));
+            out.put(txt);
+        }
+        out.close();
+        return;
+    }
+
+    for (auto* t : all) {
+        out.put("{\"i\":", 5);
+        out.putNum(t->getTokenIndex());
+        out.put(",\"type\":", 8);
+        // EOF is size_t(-1); keep it readable as -1
+        if (t->getType() == antlr4::Token::EOF) out.put("-1", 2);
+        else out.putNum(t->getType());
+        out.put(",\"name\":", 8);
+        // literal tokens have no symbolic name: display name falls back to "'('", EOF -> "EOF"
+        putJsonString(out, vocab.getDisplayName(t->getType()));
+        out.put(",\"line\":", 8);
+        out.putNum(t->getLine());
+        out.put(",\"col\":", 7);
+        out.putNum(t->getCharPositionInLine());
+        out.put(",\"start\":", 9);
+        out.putNum(t->getStartIndex());
+        out.put(",\"stop\":", 8);
+        out.putNum(t->getStopIndex());
+        out.put(",\"text\":", 8);
+        putJsonString(out, t->getText());
+        out.put("}\n", 2);
+    }
+    out.close();
+}
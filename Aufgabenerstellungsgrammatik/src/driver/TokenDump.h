@@ -0,0 +1,18 @@
+// ============================================================================
+// File: src/driver/TokenDump.h
+// Debug-only token dump (--dump-tokens), JSONL or compact binary
+// ============================================================================
+#pragma once
+
+#include <string>
+
+#include "antlr4-runtime.h"
+
+// Writes every token of `tokens` (fills the stream first) to `path`.
+//   *.bin -> binary:  "AUFT" u32 version=1, u32 count, then per token
+//                     u16 type, u32 line, u32 col, u32 start, u32 stop, u32 len, len bytes
+//   "-"   -> JSONL on stdout
+//   else  -> JSONL:   {"i":..,"type":..,"name":"..","line":..,"col":..,"start":..,"stop":..,"text":".."}
+// All integers little-endian. Throws std::runtime_error if the file cannot be written.
+void dumpTokens(antlr4::CommonTokenStream& tokens, const antlr4::dfa::Vocabulary& vocab,
+                const std::string& path);
@@ -0,0 +1,234 @@
+// ============================================================================
+// File: src/driver/Verify.cpp
+// ============================================================================
+#include "driver/Verify.h"
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "antlr4-runtime.h"
+#include "AufgabenerstellungsgrammatikLexer.h"
+
+#include "driver/Batch.h"
+#include "driver/Compiler.h"
+#include "driver/TaskCache.h"
+#include "domain/DomainBinary.h"
+#include "domain/DomainConvert.h"
+#include "domain/DomainJson.h"
+#include "native/NativeLexer.h"
+#include "native/NativeParser.h"
+
+static std::string describe(size_t type, const std::string& text, size_t line, size_t col) {
+    std::string t = text;
+    for (char& c : t) {
+        if (c == '\n') c = '#';
+    }
+    return "type=" + (type == antlr4::Token::EOF ? std::string("EOF") : std::to_string(type)) +
+           " line=" + std::to_string(line) + ":" + std::to_string(col) + " text='" + t + "'";
+}
+
+bool verifyLexer(const std::string& input, std::string& report) {
+    // reference: generated lexer
+    antlr4::ANTLRInputStream stream;
+    stream.load(input.data(), input.size(), false);
+    AufgabenerstellungsgrammatikLexer lexer(&stream);
+    DiagnosticListener antlrErrors;
+    lexer.removeErrorListeners();
+    lexer.addErrorListener(&antlrErrors);
+
+    std::vector<NativeLexError> nativeErrors;
+    const std::vector<NativeToken> native = lexAll(input, &nativeErrors);
+
+    for (size_t i = 0;; ++i) {
+        std::unique_ptr<antlr4::Token> ref = lexer.nextToken();
+        const size_t refType = ref->getType();
+
+        if (i >= native.size()) {
+            report = "token " + std::to_string(i) + ": native lexer ended early, antlr has " +
+                     describe(refType, ref->getText(), ref->getLine(), ref->getCharPositionInLine());
+            return false;
+        }
+
+        const NativeToken& nt = native[i];
+        const size_t ntType = nt.type == NativeTokenType::Eof ? antlr4::Token::EOF
+                                                              : static_cast<size_t>(nt.type);
+        const std::string ntText = nt.type == NativeTokenType::Eof ? "<EOF>" : std::string(nt.text);
+
+        if (ntType != refType || ntText != ref->getText() || nt.line != ref->getLine() ||
+            nt.column != ref->getCharPositionInLine()) {
+            report = "token " + std::to_string(i) + ": antlr " +
+                     describe(refType, ref->getText(), ref->getLine(), ref->getCharPositionInLine()) +
+                     " / native " + describe(ntType, ntText, nt.line, nt.column);
+            return false;
+        }
+
+        if (refType == antlr4::Token::EOF) break;
+    }
+
+    if (nativeErrors.size() != antlrErrors.messages.size()) {
+        report = "lexer errors: antlr " + std::to_string(antlrErrors.messages.size()) +
+                 " / native " + std::to_string(nativeErrors.size());
+        return false;
+    }
+    for (size_t i = 0; i < nativeErrors.size(); ++i) {
+        const auto& e = nativeErrors[i];
+        const std::string msg = "line " + std::to_string(e.line) + ":" + std::to_string(e.column) +
+                                " " + e.message;
+        if (msg != antlrErrors.messages[i]) {
+            report = "lexer error " + std::to_string(i) + ": antlr '" + antlrErrors.messages[i] +
+                     "' / native '" + msg + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool verifyFrontend(const std::string& input, std::string& report, ProgramD* accepted) {
+    // reference: ANTLR parse tree + IRBuilder
+    CompilerOptions refOpts;
+    refOpts.frontend = FrontendKind::Antlr;
+    Compiler reference(refOpts);
+    ProgramD refProg;
+    FileResult refRes;
+    const bool refOk = reference.compile(input, "<verify>", refProg, refRes);
+
+    ProgramIR nativeIR;
+    NativeParser native(input, *nativeIR.arenas.emplace_back(std::make_shared<Arena>()));
+    const bool nativeOk = native.parseProgram(nativeIR);
+
+    if (!refOk && !nativeOk) return true; // both reject
+    if (refOk != nativeOk) {
+        report = refOk ? "native parser rejects valid input: " + native.error()
+                       : "native parser accepts invalid input (" + refRes.error + ")";
+        return false;
+    }
+
+    std::string nativeJson;
+    try {
+        nativeJson = domainToJson(convertProgram(std::move(nativeIR)));
+    } catch (const std::exception& ex) {
+        report = std::string("native IR -> Domain failed: ") + ex.what();
+        return false;
+    }
+    const std::string refJson = domainToJson(refProg);
+    if (nativeJson == refJson) {
+        if (accepted) *accepted = std::move(refProg);
+        return true;
+    }
+
+    size_t at = 0;
+    while (at < refJson.size() && at < nativeJson.size() && refJson[at] == nativeJson[at]) ++at;
+    const size_t from = at < 40 ? 0 : at - 40;
+    report = "JSON differs at byte " + std::to_string(at) + ": antlr '" + refJson.substr(from, 80) +
+             "' / native '" + nativeJson.substr(from, 80) + "'";
+    return false;
+}
+
+bool verifyOutputs(const ProgramD& prog, std::string& report) {
+    const std::string json = domainToJson(prog);
+
+    // single-pass pretty writer vs. the two-pass reference formatter
+    if (domainToJson(prog, JsonStyle::Pretty) != prettyJsonDomain(json)) {
+        report = "streaming pretty JSON differs from prettyJsonDomain()";
+        return false;
+    }
+
+    // binary round trip must decode to the same JSON
+    std::string decoded;
+    try {
+        decoded = domainToJson(domainFromBinary(domainToBinary(prog)));
+    } catch (const std::exception& ex) {
+        report = std::string("binary round trip failed: ") + ex.what();
+        return false;
+    }
+    if (decoded != json) {
+        report = "binary round trip decodes to different JSON";
+        return false;
+    }
+    return true;
+}
+
+bool verifyCache(const std::string& input, const ProgramD& expected, std::string& report) {
+    const std::string json = domainToJson(expected);
+    TaskCache cache;
+    Compiler compiler;
+
+    for (const char* pass : {"cold", "warm"}) {
+        const ParseStats before = compiler.stats();
+        ProgramD prog;
+        FileResult res;
+        if (!compiler.compileCached(input, "<verify>", cache, prog, res)) {
+            report = std::string(pass) + " cached compile failed: " + res.error;
+            return false;
+        }
+        if (domainToJson(prog) != json) {
+            report = std::string(pass) + " cached compile gives different JSON";
+            return false;
+        }
+        const ParseStats& after = compiler.stats();
+        const size_t parses = after.nativeParses + after.sllParses + after.llFallbacks -
+                              (before.nativeParses + before.sllParses + before.llFallbacks);
+        if (pass[0] == 'w' && cache.size() > 0 && parses != 0) {
+            report = "warm cached compile parsed " + std::to_string(parses) + " task(s) again";
+            return false;
+        }
+    }
+    return true;
+}
+
+int runVerify(const std::vector<std::string>& specs) {
+    std::vector<std::string> inputs;
+    try {
+        inputs = expandInputs(specs);
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    if (inputs.empty()) {
+        std::cerr << "Keine Eingabedateien gefunden.\n";
+        return 1;
+    }
+
+    size_t failed = 0;
+    for (const auto& path : inputs) {
+        std::string input;
+        try {
+            input = readInputFile(path);
+        } catch (const std::exception& ex) {
+            std::cerr << "[fail] " << path << ": " << ex.what() << "\n";
+            ++failed;
+            continue;
+        }
+
+        std::string report;
+        if (!verifyLexer(input, report)) {
+            std::cerr << "[diff] " << path << " (lexer): " << report << "\n";
+            ++failed;
+            continue;
+        }
+        ProgramD prog;
+        if (!verifyFrontend(input, report, &prog)) {
+            std::cerr << "[diff] " << path << " (frontend): " << report << "\n";
+            ++failed;
+            continue;
+        }
+        if (!verifyOutputs(prog, report)) {
+            std::cerr << "[diff] " << path << " (output): " << report << "\n";
+            ++failed;
+            continue;
+        }
+        if (!prog.tasks.empty() && !verifyCache(input, prog, report)) {
+            std::cerr << "[diff] " << path << " (cache): " << report << "\n";
+            ++failed;
+            continue;
+        }
+        std::cerr << "[ok]   " << path << "\n";
+    }
+
+    std::cerr << "\n=== VERIFY SUMMARY ===\n"
+              << "total=" << inputs.size() << ", ok=" << (inputs.size() - failed)
+              << ", diff=" << failed << "\n";
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+// ============================================================================
+// File: src/driver/Verify.h
+// Differential checks: hand-written components vs. the ANTLR reference
+// ============================================================================
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "domain/Domain.h"
+
+// Native lexer vs. generated lexer: same token types, texts, line:col and
+// the same token recognition errors. Start/stop indices are not compared
+// (bytes vs. code points). Returns false and fills `report` on the first mismatch.
+bool verifyLexer(const std::string& input, std::string& report);
+
+// NativeParser vs. parse tree + IRBuilder: both accept the input and produce
+// byte-identical domain JSON, or both reject it. If both accept, the program
+// is stored in `accepted` (when given).
+bool verifyFrontend(const std::string& input, std::string& report, ProgramD* accepted = nullptr);
+
+// Writers: streaming pretty JSON == prettyJsonDomain(domainToJson()), and the
+// binary format decodes back to the same JSON.
+bool verifyOutputs(const ProgramD& prog, std::string& report);
+
+// Per-task cache: a cold and a warm Compiler::compileCached run over an
+// in-memory TaskCache both give the JSON of `expected`; the warm run parses nothing.
+bool verifyCache(const std::string& input, const ProgramD& expected, std::string& report);
+
+// Runs every check on each input (files, directories, globs, @lists as in --batch).
+// Returns the process exit code.
+int runVerify(const std::vector<std::string>& specs);
@@ -0,0 +1,253 @@
+// ============================================================================
+// File: src/driver/Watch.cpp
+// ============================================================================
+#include "driver/Watch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "driver/Batch.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Names (relative to the directory) of files that were written or moved in.
+class DirWatcher {
+public:
+    explicit DirWatcher(const std::string& dir); // throws std::runtime_error
+    ~DirWatcher();
+
+    DirWatcher(const DirWatcher&) = delete;
+    DirWatcher& operator=(const DirWatcher&) = delete;
+
+    // Waits up to `timeoutMillis` (-1 = no limit) and appends the changed names.
+    // Sets `overflow` if the kernel dropped events: the names are incomplete.
+    // false once the directory is gone (deleted, moved, unmounted).
+    bool wait(int timeoutMillis, std::vector<std::string>& names, bool& overflow);
+
+private:
+#ifdef _WIN32
+    bool arm();
+    void close();
+
+    HANDLE dirHandle = INVALID_HANDLE_VALUE;
+    OVERLAPPED overlapped{};
+    alignas(DWORD) char buffer[64 * 1024];
+#elif defined(__linux__)
+    int fd = -1;
+#endif
+};
+
+#ifdef _WIN32
+DirWatcher::DirWatcher(const std::string& dir) {
+    dirHandle = CreateFileA(dir.c_str(), FILE_LIST_DIRECTORY,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (dirHandle == INVALID_HANDLE_VALUE || !overlapped.hEvent || !arm()) {
+        close();
+        throw std::runtime_error("Konnte Ordner nicht beobachten: " + dir);
+    }
+}
+
+DirWatcher::~DirWatcher() {
+    close();
+}
+
+void DirWatcher::close() {
+    if (dirHandle != INVALID_HANDLE_VALUE) {
+        CancelIo(dirHandle);
+        CloseHandle(dirHandle);
+        dirHandle = INVALID_HANDLE_VALUE;
+    }
+    if (overlapped.hEvent) {
+        CloseHandle(overlapped.hEvent);
+        overlapped.hEvent = nullptr;
+    }
+}
+
+bool DirWatcher::arm() {
+    ResetEvent(overlapped.hEvent);
+    return ReadDirectoryChangesW(dirHandle, buffer, sizeof(buffer), FALSE,
+                                 FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE, nullptr,
+                                 &overlapped, nullptr) != 0;
+}
+
+bool DirWatcher::wait(int timeoutMillis, std::vector<std::string>& names, bool& overflow) {
+    const DWORD r = WaitForSingleObject(overlapped.hEvent, timeoutMillis < 0 ? INFINITE : DWORD(timeoutMillis));
+    if (r == WAIT_TIMEOUT) return true;
+
+    DWORD bytes = 0;
+    if (r != WAIT_OBJECT_0 || !GetOverlappedResult(dirHandle, &overlapped, &bytes, FALSE)) return false;
+
+    // bytes == 0: the buffer overflowed, the events are lost
+    if (bytes == 0) overflow = true;
+    for (DWORD offset = 0; bytes > 0;) {
+        const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(buffer + offset);
+        if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED ||
+            info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+            // same code page as the std::string paths everywhere else
+            const int wlen = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+            const int len = WideCharToMultiByte(CP_ACP, 0, info->FileName, wlen, nullptr, 0, nullptr, nullptr);
+            std::string name(static_cast<size_t>(len), '\0');
+            WideCharToMultiByte(CP_ACP, 0, info->FileName, wlen, name.data(), len, nullptr, nullptr);
+            names.push_back(std::move(name));
+        }
+        if (info->NextEntryOffset == 0) break;
+        offset += info->NextEntryOffset;
+    }
+    return arm();
+}
+#elif defined(__linux__)
+DirWatcher::DirWatcher(const std::string& dir) {
+    fd = ::inotify_init1(IN_CLOEXEC);
+    // IN_CLOSE_WRITE: saved in place, IN_MOVED_TO: saved via temp file + rename
+    if (fd < 0 || ::inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE_SELF |
+                                                           IN_MOVE_SELF | IN_ONLYDIR) < 0) {
+        const std::string reason = std::strerror(errno);
+        if (fd >= 0) ::close(fd);
+        throw std::runtime_error("Konnte Ordner nicht beobachten: " + dir + " (" + reason + ")");
+    }
+}
+
+DirWatcher::~DirWatcher() {
+    ::close(fd);
+}
+
+bool DirWatcher::wait(int timeoutMillis, std::vector<std::string>& names, bool& overflow) {
+    pollfd p{fd, POLLIN, 0};
+    const int r = ::poll(&p, 1, timeoutMillis);
+    if (r < 0) return errno == EINTR;
+    if (r == 0) return true;
+
+    alignas(inotify_event) char buf[16 * 1024];
+    const ssize_t n = ::read(fd, buf, sizeof(buf));
+    if (n < 0) return errno == EINTR || errno == EAGAIN;
+
+    bool alive = true;
+    for (ssize_t off = 0; off < n;) {
+        const auto* ev = reinterpret_cast<const inotify_event*>(buf + off);
+        if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED | IN_UNMOUNT)) alive = false;
+        else if (ev->mask & IN_Q_OVERFLOW) overflow = true; // wd -1, no name
+        else if (ev->len > 0) names.emplace_back(ev->name);
+        off += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+    }
+    return alive;
+}
+#else
+DirWatcher::DirWatcher(const std::string&) {
+    throw std::runtime_error("--watch wird auf diesem System nicht unterstützt.");
+}
+
+DirWatcher::~DirWatcher() = default;
+
+bool DirWatcher::wait(int, std::vector<std::string>&, bool&) {
+    return false;
+}
+#endif
+
+std::string outputFor(const std::string& input, const WatchOptions& opts) {
+    return outputPathsFor({input}, opts.outDir, outputExtension(opts.compiler.format)).front();
+}
+
+// make-style: output missing or older than its input
+bool isStale(const std::string& input, const std::string& output) {
+    std::error_code ec;
+    const auto out = fs::last_write_time(output, ec);
+    if (ec) return true;
+    const auto in = fs::last_write_time(input, ec);
+    return ec || out < in;
+}
+
+} // namespace
+
+int runWatch(const WatchOptions& opts) {
+    if (!fs::is_directory(opts.dir)) {
+        std::cerr << "Kein Ordner: " << opts.dir << "\n";
+        return 1;
+    }
+
+    // Editors may truncate a file while it is compiled: a mapping would fault
+    // (SIGBUS), a copy just yields a stale or broken build that the next save fixes.
+    CompilerOptions compilerOpts = opts.compiler;
+    compilerOpts.mapInput = false;
+    Compiler compiler(compilerOpts); // stays warm for the whole session
+    auto build = [&](const std::string& input) {
+        printFileResult(compiler.compileFile(input, outputFor(input, opts)));
+    };
+
+    try {
+        // watch first, so nothing saved during the initial build is missed
+        DirWatcher watcher(opts.dir);
+
+        for (const auto& input : expandInputs({opts.dir})) {
+            if (isStale(input, outputFor(input, opts))) build(input);
+        }
+        std::cerr << "[watch] beobachte " << opts.dir << " -> " << opts.outDir << "\n";
+
+        std::set<std::string> pending; // sorted: a burst is compiled in name order
+        auto quietSince = Clock::now();
+        for (;;) {
+            int timeout = -1;
+            if (!pending.empty()) {
+                const auto left = std::chrono::milliseconds(opts.debounceMillis) - (Clock::now() - quietSince);
+                timeout = static_cast<int>(std::max<long long>(
+                    0, std::chrono::ceil<std::chrono::milliseconds>(left).count()));
+            }
+
+            std::vector<std::string> names;
+            bool overflow = false;
+            if (!watcher.wait(timeout, names, overflow)) {
+                std::cerr << "[watch] Ordner nicht mehr verfügbar: " << opts.dir << "\n";
+                return 1;
+            }
+            if (overflow) {
+                // events were dropped: fall back to the make-style check of the initial build
+                std::cerr << "[watch] Ereignisse verloren, prüfe " << opts.dir << " neu\n";
+                for (const auto& input : expandInputs({opts.dir})) {
+                    if (isStale(input, outputFor(input, opts))) pending.insert(input);
+                }
+                quietSince = Clock::now();
+            }
+            for (const auto& name : names) {
+                if (fs::path(name).extension() != ".txt") continue;
+                pending.insert((fs::path(opts.dir) / name).string());
+                quietSince = Clock::now();
+            }
+
+            if (pending.empty() || Clock::now() - quietSince < std::chrono::milliseconds(opts.debounceMillis)) {
+                continue;
+            }
+            for (const auto& input : pending) {
+                std::error_code ec;
+                if (fs::is_regular_file(input, ec)) build(input); // gone again: nothing to do
+            }
+            pending.clear();
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+}
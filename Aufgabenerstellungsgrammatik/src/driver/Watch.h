@@ -0,0 +1,22 @@
+// ============================================================================
+// File: src/driver/Watch.h
+// --watch: recompile changed DSL files of a directory with one warm Compiler
+// ============================================================================
+#pragma once
+
+#include <string>
+
+#include "driver/Compiler.h"
+
+struct WatchOptions {
+    std::string dir;          // watched directory (its *.txt, like --batch with a directory)
+    std::string outDir;       // <outDir>/<stem>.json|.bin
+    int debounceMillis = 100; // quiet time after the last write before compiling
+    CompilerOptions compiler;
+};
+
+// Compiles every input whose output is missing or older, then waits for
+// change notifications (inotify on Linux, ReadDirectoryChangesW on Windows).
+// A burst of writes is compiled once, after `debounceMillis` without events.
+// Runs until interrupted or the directory goes away; returns the exit code.
+int runWatch(const WatchOptions& opts);
@@ -0,0 +1,164 @@
+// ============================================================================
+// File: src/driver/WorkStealingPool.h
+// Fixed-size thread pool with one deque per worker + stealing
+// ============================================================================
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Owner pops LIFO from its own deque, idle workers steal FIFO from the others,
+// so one long job never leaves the remaining queued work stuck behind it.
+// Jobs receive the worker index, which lets callers keep per-thread state
+// (e.g. one Compiler per worker) without locking.
+class WorkStealingPool {
+public:
+    using Job = std::function<void(size_t worker)>;
+
+    explicit WorkStealingPool(size_t threads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    // From a worker thread the job goes to that worker's own deque,
+    // otherwise the deques are filled round-robin.
+    void submit(Job job);
+
+    // Blocks until every submitted job has finished; rethrows the first job exception.
+    void wait();
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<Job> jobs;
+    };
+
+    bool popLocal(size_t id, Job& out);
+    bool steal(size_t id, Job& out);
+    void workerLoop(size_t id);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCv;
+    std::atomic<long> queued{0};
+    bool stopping = false;
+
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    size_t pending = 0;
+    std::exception_ptr firstError;
+
+    std::atomic<size_t> nextQueue{0};
+};
+
+inline size_t& currentPoolWorker() {
+    static thread_local size_t id = static_cast<size_t>(-1);
+    return id;
+}
+
+inline WorkStealingPool::WorkStealingPool(size_t threads) {
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+inline WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lk(sleepMutex);
+        stopping = true;
+    }
+    sleepCv.notify_all();
+    for (auto& w : workers) w.join();
+}
+
+inline void WorkStealingPool::submit(Job job) {
+    {
+        std::lock_guard<std::mutex> lk(doneMutex);
+        ++pending;
+    }
+
+    size_t self = currentPoolWorker();
+    size_t target = (self < queues.size()) ? self : nextQueue.fetch_add(1) % queues.size();
+    {
+        std::lock_guard<std::mutex> lk(queues[target]->m);
+        queues[target]->jobs.push_back(std::move(job));
+    }
+    {
+        std::lock_guard<std::mutex> lk(sleepMutex);
+        ++queued;
+    }
+    sleepCv.notify_one();
+}
+
+inline void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lk(doneMutex);
+    doneCv.wait(lk, [this] { return pending == 0; });
+    if (firstError) {
+        std::exception_ptr e = firstError;
+        firstError = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+inline bool WorkStealingPool::popLocal(size_t id, Job& out) {
+    Queue& q = *queues[id];
+    std::lock_guard<std::mutex> lk(q.m);
+    if (q.jobs.empty()) return false;
+    out = std::move(q.jobs.back());
+    q.jobs.pop_back();
+    return true;
+}
+
+inline bool WorkStealingPool::steal(size_t id, Job& out) {
+    for (size_t k = 1; k < queues.size(); ++k) {
+        Queue& q = *queues[(id + k) % queues.size()];
+        std::lock_guard<std::mutex> lk(q.m);
+        if (q.jobs.empty()) continue;
+        out = std::move(q.jobs.front());
+        q.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+inline void WorkStealingPool::workerLoop(size_t id) {
+    currentPoolWorker() = id;
+
+    for (;;) {
+        Job job;
+        if (popLocal(id, job) || steal(id, job)) {
+            --queued;
+            try {
+                job(id);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(doneMutex);
+                if (!firstError) firstError = std::current_exception();
+            }
+            bool done = false;
+            {
+                std::lock_guard<std::mutex> lk(doneMutex);
+                done = (--pending == 0);
+            }
+            if (done) doneCv.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk(sleepMutex);
+        sleepCv.wait(lk, [this] { return stopping || queued > 0; });
+        if (stopping && queued <= 0) return;
+    }
+}
@@ -0,0 +1,181 @@
+// ============================================================================
+// File: src/grading/AnswerKey.cpp
+// ============================================================================
+#include "grading/AnswerKey.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <variant>
+
+#if defined(__AVX2__)
+#define ANSWER_KEY_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANSWER_KEY_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+int popcount64(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(x));
+#elif defined(_MSC_VER) && !defined(__clang__)
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<int>((x * 0x0101010101010101ull) >> 56);
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+static inline unsigned lowestSetBit(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return static_cast<unsigned>(idx);
+#elif defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<unsigned>(popcount64((x & (0 - x)) - 1));
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+AnswerKey buildAnswerKey(const TaskD& task) {
+    AnswerKey key;
+    key.kind = taskKind(task);
+
+    if (const auto* rof = std::get_if<RoFTaskD>(&task)) {
+        RoFKey& k = key.rof;
+        k.lineCount = static_cast<uint32_t>(rof->lines.size());
+        k.truth.assign(bitWords(k.lineCount), 0);
+        for (size_t i = 0; i < rof->lines.size(); ++i) {
+            if (rof->lines[i].answer.isTrue) setBit(k.truth.data(), i);
+        }
+    }
+    else if (const auto* sorting = std::get_if<SortingTaskD>(&task)) {
+        key.sorting.items.resize(sorting->lines.size());
+        for (size_t l = 0; l < sorting->lines.size(); ++l) {
+            const SortingLineIR& line = sorting->lines[l];
+            if (line.points.scoringMode != ScoringModeIR::PartialInOrder) continue;
+            key.sorting.items[l].build(line.items, [](IRString s) { return s; });
+        }
+    }
+    else if (const auto* matching = std::get_if<MatchingTaskD>(&task)) {
+        key.matching.lefts.resize(matching->lines.size());
+        for (size_t l = 0; l < matching->lines.size(); ++l) {
+            key.matching.lefts[l].build(matching->lines[l].pairs, [](const MatchingItemIR& p) { return p.left; });
+        }
+    }
+    else if (const auto* choice = std::get_if<ChoiceTaskD>(&task)) {
+        ChoiceKey& k = key.choice;
+        k.wordBegin.push_back(0);
+        k.pointBegin.push_back(0);
+        for (const ChoiceLineIR& line : choice->lines) {
+            const size_t n = line.options.size();
+            const size_t words = bitWords(n);
+            const size_t lanes = (n + ChoiceKey::kPointLanes - 1) / ChoiceKey::kPointLanes * ChoiceKey::kPointLanes;
+
+            const size_t w0 = k.correct.size();
+            k.correct.resize(w0 + words, 0);
+            const size_t p0 = k.points.size();
+            k.points.resize(p0 + lanes, 0);
+            for (size_t o = 0; o < n; ++o) {
+                if (line.options[o].isCorrect) setBit(k.correct.data() + w0, o);
+                k.points[p0 + o] = line.options[o].points;
+            }
+
+            k.optionCount.push_back(static_cast<uint32_t>(n));
+            k.wordBegin.push_back(static_cast<uint32_t>(k.correct.size()));
+            k.pointBegin.push_back(static_cast<uint32_t>(k.points.size()));
+        }
+    }
+    return key;
+}
+
+std::vector<AnswerKey> buildAnswerKeys(const ProgramD& program) {
+    std::vector<AnswerKey> keys;
+    keys.reserve(program.tasks.size());
+    for (const TaskD& task : program.tasks) keys.push_back(buildAnswerKey(task));
+    return keys;
+}
+
+int maskedSumScalar(uint64_t mask, const int32_t* points, size_t lanes) {
+    if (lanes < 64) mask &= (uint64_t(1) << lanes) - 1;
+    int sum = 0;
+    for (; mask; mask &= mask - 1) sum += points[lowestSetBit(mask)];
+    return sum;
+}
+
+// Per group of lanes: spread the group's mask bits over the lanes
+// ((bits & [1, 2, 4, ...]) == [1, 2, 4, ...]), AND with the points, add.
+int maskedSum(uint64_t mask, const int32_t* points, size_t lanes) {
+#if defined(ANSWER_KEY_AVX2)
+    const __m256i bit = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256i acc = _mm256_setzero_si256();
+    for (size_t i = 0; i < lanes; i += 8) {
+        const __m256i bits = _mm256_set1_epi32(static_cast<int>((mask >> i) & 0xFF));
+        const __m256i on = _mm256_cmpeq_epi32(_mm256_and_si256(bits, bit), bit);
+        const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(points + i));
+        acc = _mm256_add_epi32(acc, _mm256_and_si256(on, p));
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+#elif defined(ANSWER_KEY_SSE2)
+    const __m128i bit = _mm_setr_epi32(1, 2, 4, 8);
+    __m128i acc = _mm_setzero_si128();
+    for (size_t i = 0; i < lanes; i += 4) {
+        const __m128i bits = _mm_set1_epi32(static_cast<int>((mask >> i) & 0xF));
+        const __m128i on = _mm_cmpeq_epi32(_mm_and_si128(bits, bit), bit);
+        const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(points + i));
+        acc = _mm_add_epi32(acc, _mm_and_si128(on, p));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+#else
+    return maskedSumScalar(mask, points, lanes);
+#endif
+}
+
+int choiceLinePoints(const ChoiceKey& key, size_t line, const uint64_t* selected) {
+    const int32_t* points = key.points.data() + key.pointBegin[line];
+    const size_t lanes = key.pointBegin[line + 1] - key.pointBegin[line];
+    int sum = 0;
+    for (size_t w = 0; w < key.words(line); ++w) {
+        if (selected[w]) sum += maskedSum(selected[w], points + 64 * w, std::min<size_t>(lanes - 64 * w, 64));
+    }
+    return sum;
+}
+
+ChoiceHits choiceLineHits(const ChoiceKey& key, size_t line, const uint64_t* selected) {
+    const uint64_t* correct = key.correct.data() + key.wordBegin[line];
+    ChoiceHits hits;
+    for (size_t w = 0; w < key.words(line); ++w) {
+        hits.correct += popcount64(selected[w] & correct[w]);
+        hits.wrong += popcount64(selected[w] & ~correct[w]);
+        hits.missed += popcount64(~selected[w] & correct[w]);
+    }
+    return hits;
+}
+
+int rofPoints(const RoFKey& key, const uint64_t* answered, const uint64_t* givenTrue) {
+    int points = 0;
+    for (size_t w = 0; w < key.words(); ++w) points += popcount64(answered[w] & ~(givenTrue[w] ^ key.truth[w]));
+    return points;
+}
+
+const char* answerKeyImpl() {
+#if defined(ANSWER_KEY_AVX2)
+    return "avx2";
+#elif defined(ANSWER_KEY_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,128 @@
+// ============================================================================
+// File: src/grading/AnswerKey.h
+// Precompiled answer keys: Auswahl/RoF bitsets, Umordnung/Zuordnung text indexes
+// ============================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "domain/Domain.h"
+
+// A student's answer to an Auswahl line or a RoF task is a bitset: option k /
+// line k is bit (k % 64) of word k / 64. The keys below store the solution in
+// the same shape, so scoring is AND + popcount (RoF, correct-option hits) and
+// a masked dot product with the option points (Auswahl).
+
+// All Auswahl lines of one task, flattened. Line l owns
+//   correct[wordBegin[l], wordBegin[l + 1])   isCorrect bits
+//   points [pointBegin[l], pointBegin[l + 1]) option points, zero-padded to
+//                                              a multiple of kPointLanes
+struct ChoiceKey {
+    static constexpr size_t kPointLanes = 8; // one AVX2 register of int32
+
+    std::vector<uint32_t> optionCount;
+    std::vector<uint32_t> wordBegin;  // lines() + 1 entries
+    std::vector<uint32_t> pointBegin; // lines() + 1 entries
+    std::vector<uint64_t> correct;
+    std::vector<int32_t> points;
+
+    size_t lines() const { return optionCount.size(); }
+    size_t words(size_t line) const { return wordBegin[line + 1] - wordBegin[line]; }
+};
+
+// Truth value of RoF line k = bit k
+struct RoFKey {
+    std::vector<uint64_t> truth;
+    uint32_t lineCount = 0;
+
+    size_t words() const { return truth.size(); }
+};
+
+// Hash index over the texts of one line (Umordnung items, Zuordnung left
+// sides): first[text] is the first position with that text, next[pos] the
+// following one with the same text (kNone at the end of the chain).
+struct TextIndex {
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    std::unordered_map<std::string_view, uint32_t> first;
+    std::vector<uint32_t> next;
+
+    template <class Range, class Text>
+    void build(const Range& entries, Text text) {
+        first.reserve(entries.size());
+        next.assign(entries.size(), kNone);
+        std::vector<uint32_t> tail(entries.size()); // last position of each chain, by its first
+        for (uint32_t i = 0; i < entries.size(); ++i) {
+            const auto [it, inserted] = first.emplace(text(entries[i]), i);
+            if (!inserted) next[tail[it->second]] = i;
+            tail[it->second] = i;
+        }
+    }
+
+    uint32_t find(std::string_view text) const {
+        const auto it = first.find(text);
+        return it == first.end() ? kNone : it->second;
+    }
+};
+
+// Per line; `items` is only built for PartialInOrder lines (LIS scoring)
+struct SortingKey {
+    std::vector<TextIndex> items;
+};
+
+// Per line, left sides -> pair indices
+struct MatchingKey {
+    std::vector<TextIndex> lefts;
+};
+
+// Keys for one task; only the member matching `kind` is filled
+struct AnswerKey {
+    TaskKind kind = TaskKind::Unknown;
+    ChoiceKey choice;
+    RoFKey rof;
+    SortingKey sorting;
+    MatchingKey matching;
+};
+
+AnswerKey buildAnswerKey(const TaskD& task);
+
+// One key per task of `program`, in program order
+std::vector<AnswerKey> buildAnswerKeys(const ProgramD& program);
+
+inline size_t bitWords(size_t bits) { return (bits + 63) / 64; }
+
+inline void setBit(uint64_t* words, size_t k) { words[k / 64] |= uint64_t(1) << (k % 64); }
+
+int popcount64(uint64_t x);
+
+// Sum of the points of the selected options of `line` (`selected` has
+// key.words(line) words; bits past the option count must be clear). Not
+// clamped: Grader applies the "at least 0" rule.
+int choiceLinePoints(const ChoiceKey& key, size_t line, const uint64_t* selected);
+
+struct ChoiceHits {
+    int correct = 0; // selected and marked correct
+    int wrong = 0;   // selected but not marked correct
+    int missed = 0;  // marked correct but not selected
+};
+
+ChoiceHits choiceLineHits(const ChoiceKey& key, size_t line, const uint64_t* selected);
+
+// Lines answered (bit set in `answered`) with the value in `givenTrue`;
+// one point per answered line that matches the key. Both have key.words() words.
+int rofPoints(const RoFKey& key, const uint64_t* answered, const uint64_t* givenTrue);
+
+// sum(points[k] for every set bit k of mask); `points` holds 64 readable lanes
+// or, for the last word of a line, the line's padded lane count (`lanes`, a
+// multiple of ChoiceKey::kPointLanes). Picked at compile time like findJsonEscape.
+int maskedSum(uint64_t mask, const int32_t* points, size_t lanes);
+
+// Bit-at-a-time reference for maskedSum
+int maskedSumScalar(uint64_t mask, const int32_t* points, size_t lanes);
+
+// "avx2", "sse2" or "scalar"
+const char* answerKeyImpl();
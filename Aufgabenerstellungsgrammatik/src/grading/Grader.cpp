@@ -0,0 +1,308 @@
+// ============================================================================
+// File: src/grading/Grader.cpp
+// ============================================================================
+#include "grading/Grader.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+
+namespace {
+
+[[noreturn]] void badShape(const char* expected) {
+    throw std::runtime_error(std::string(expected) + " erwartet");
+}
+
+void expect(const JsonNode& n, JsonType type, const char* what) {
+    if (n.type != type) badShape(what);
+}
+
+int maxFor(const TaskPointsIR& p, size_t count) {
+    if (p.scoringMode == ScoringModeIR::AllOrNothing) return p.pointsIfAllCorrect.value_or(0);
+    return static_cast<int>(count);
+}
+
+int applyMode(const TaskPointsIR& p, int correct, bool allRight) {
+    if (p.scoringMode == ScoringModeIR::AllOrNothing) return allRight ? p.pointsIfAllCorrect.value_or(0) : 0;
+    return correct;
+}
+
+// "already used" flags for marks, sorting positions and matching pairs; reused per thread
+std::vector<char>& usedFlags(size_t n) {
+    thread_local std::vector<char> flags;
+    flags.assign(n, 0);
+    return flags;
+}
+
+// Cleared answer bitsets (see AnswerKey.h); `slot` 0/1 gives two independent buffers per thread
+uint64_t* answerBits(size_t words, int slot) {
+    thread_local std::vector<uint64_t> bits[2];
+    bits[slot].assign(words, 0);
+    return bits[slot].data();
+}
+
+// Answer = array with one entry per line; null entries and lines without an
+// entry score 0, entries past the last line are ignored.
+template <class Line, class Fn>
+int perLine(const IRVector<Line>& lines, const JsonNode& answer, const JsonDocument& doc, Fn scoreLine) {
+    expect(answer, JsonType::Array, "Liste (eine Antwort pro Zeile)");
+    int sum = 0;
+    size_t i = 0;
+    doc.forEachChild(answer, [&](const JsonNode& a) {
+        if (i < lines.size() && a.type != JsonType::Null) sum += scoreLine(i, lines[i], a);
+        ++i;
+    });
+    return sum;
+}
+
+int scoreSortingLine(const SortingLineIR& line, const JsonNode& a, const JsonDocument& doc) {
+    expect(a, JsonType::Array, "Liste der Elemente");
+    int correct = 0;
+    size_t pos = 0;
+    doc.forEachChild(a, [&](const JsonNode& item) {
+        expect(item, JsonType::String, "Element als String");
+        if (pos < line.items.size() && item.text == line.items[pos]) ++correct;
+        ++pos;
+    });
+    const bool allRight = pos == line.items.size() && static_cast<size_t>(correct) == pos;
+    return applyMode(line.points, correct, allRight);
+}
+
+// PartialInOrder: every student item is mapped to its position in the key
+// (repeated texts take the next unused position, unknown items are skipped);
+// the score is the length of the longest increasing run of positions,
+// O(n log n) via patience sorting.
+int scoreSortingInOrder(const SortingLineIR& line, const TextIndex& index, const JsonNode& a,
+                        const JsonDocument& doc) {
+    expect(a, JsonType::Array, "Liste der Elemente");
+    std::vector<char>& used = usedFlags(line.items.size());
+    thread_local std::vector<uint32_t> tails; // tails[k] = smallest end of an increasing run of length k + 1
+    tails.clear();
+    doc.forEachChild(a, [&](const JsonNode& item) {
+        expect(item, JsonType::String, "Element als String");
+        uint32_t pos = index.find(item.text);
+        while (pos != TextIndex::kNone && used[pos]) pos = index.next[pos];
+        if (pos == TextIndex::kNone) return;
+        used[pos] = 1;
+        const auto it = std::lower_bound(tails.begin(), tails.end(), pos);
+        if (it == tails.end()) tails.push_back(pos);
+        else *it = pos;
+    });
+    return static_cast<int>(tails.size());
+}
+
+// Walks the student's object once; the first member per left side counts,
+// like JsonDocument::member.
+int scoreMatchingLine(const MatchingLineIR& line, const TextIndex& index, const JsonNode& a,
+                      const JsonDocument& doc) {
+    expect(a, JsonType::Object, "Objekt links -> rechts");
+    std::vector<char>& seen = usedFlags(line.pairs.size());
+    int correct = 0;
+    doc.forEachChild(a, [&](const JsonNode& member) {
+        const uint32_t first = index.find(member.key);
+        if (first == TextIndex::kNone || seen[first]) return;
+        seen[first] = 1;
+        expect(member, JsonType::String, "Zuordnung als String");
+        for (uint32_t p = first; p != TextIndex::kNone; p = index.next[p]) {
+            if (member.text == line.pairs[p].right) ++correct;
+        }
+    });
+    return applyMode(line.points, correct, static_cast<size_t>(correct) == line.pairs.size());
+}
+
+int scoreChoiceLine(const ChoiceKey& key, size_t index, const ChoiceLineIR& line, const JsonNode& a,
+                    const JsonDocument& doc) {
+    expect(a, JsonType::Array, "Liste der gewählten Optionen");
+    uint64_t* chosen = answerBits(key.words(index), 0);
+    doc.forEachChild(a, [&](const JsonNode& sel) {
+        if (sel.type == JsonType::String) {
+            for (size_t k = 0; k < line.options.size(); ++k) {
+                if (line.options[k].text == sel.text) {
+                    setBit(chosen, k);
+                    break;
+                }
+            }
+            return; // unknown text: selects nothing
+        }
+        long long k = 0;
+        if (!jsonToInt(sel, k) || k < 0 || static_cast<size_t>(k) >= line.options.size()) {
+            badShape("Optionsindex oder -text");
+        }
+        setBit(chosen, static_cast<size_t>(k));
+    });
+    return std::max(choiceLinePoints(key, index, chosen), 0);
+}
+
+} // namespace
+
+Grader::Grader(const ProgramD& program, const MatchOptions& match) {
+    keys.reserve(program.tasks.size());
+    for (const TaskD& task : program.tasks) {
+        TaskKey key;
+        key.task = &task;
+        key.answer = buildAnswerKey(task);
+
+        std::visit([&](const auto& x) {
+            using T = std::decay_t<decltype(x)>;
+            if constexpr (std::is_same_v<T, RoFTaskD>) {
+                key.maxPoints = static_cast<int>(x.lines.size());
+            }
+            else if constexpr (std::is_same_v<T, SortingTaskD>) {
+                for (const auto& l : x.lines) key.maxPoints += maxFor(l.points, l.items.size());
+            }
+            else if constexpr (std::is_same_v<T, MatchingTaskD>) {
+                for (const auto& l : x.lines) key.maxPoints += maxFor(l.points, l.pairs.size());
+            }
+            else if constexpr (std::is_same_v<T, MarkingTaskD>) {
+                for (const auto& s : x.task.sentences) {
+                    for (const auto& part : s.parts) {
+                        if (part.mark) key.spans.push_back({part.mark->markedText, part.mark->points});
+                    }
+                }
+            }
+            else if constexpr (std::is_same_v<T, ClozeTaskD>) {
+                for (const auto& s : x.task.sentences) {
+                    for (const auto& part : s.parts) {
+                        if (part.blank) key.spans.push_back({part.blank->solution, part.blank->points});
+                    }
+                }
+            }
+            else if constexpr (std::is_same_v<T, CorrectionTaskD>) {
+                for (const auto& s : x.task.sentences) {
+                    for (const auto& part : s.parts) {
+                        if (part.corr) key.spans.push_back({part.corr->correct, part.corr->points});
+                    }
+                }
+            }
+            else if constexpr (std::is_same_v<T, ChoiceTaskD>) {
+                for (const auto& l : x.lines) {
+                    for (const auto& o : l.options) key.maxPoints += std::max(o.points, 0);
+                }
+            }
+        }, task);
+
+        if (key.answer.kind == TaskKind::Cloze || key.answer.kind == TaskKind::Correction) {
+            for (const Span& s : key.spans) key.matchers.emplace_back(s.text, match);
+        }
+        for (const Span& s : key.spans) key.maxPoints += s.points;
+        totalMax += key.maxPoints;
+        keys.push_back(std::move(key));
+    }
+}
+
+int Grader::score(const TaskKey& key, const JsonNode& answer, const JsonDocument& doc) const {
+    return std::visit([&](const auto& x) -> int {
+        using T = std::decay_t<decltype(x)>;
+
+        if constexpr (std::is_same_v<T, RoFTaskD>) {
+            const RoFKey& rof = key.answer.rof;
+            uint64_t* answered = answerBits(rof.words(), 0);
+            uint64_t* givenTrue = answerBits(rof.words(), 1);
+            perLine(x.lines, answer, doc, [&](size_t i, const TrueFalseTaskIR&, const JsonNode& a) {
+                expect(a, JsonType::Bool, "true/false");
+                setBit(answered, i);
+                if (a.boolean) setBit(givenTrue, i);
+                return 0;
+            });
+            return rofPoints(rof, answered, givenTrue);
+        }
+        else if constexpr (std::is_same_v<T, SortingTaskD>) {
+            return perLine(x.lines, answer, doc, [&](size_t i, const SortingLineIR& l, const JsonNode& a) {
+                if (l.points.scoringMode == ScoringModeIR::PartialInOrder) {
+                    return scoreSortingInOrder(l, key.answer.sorting.items[i], a, doc);
+                }
+                return scoreSortingLine(l, a, doc);
+            });
+        }
+        else if constexpr (std::is_same_v<T, MatchingTaskD>) {
+            return perLine(x.lines, answer, doc, [&](size_t i, const MatchingLineIR& l, const JsonNode& a) {
+                return scoreMatchingLine(l, key.answer.matching.lefts[i], a, doc);
+            });
+        }
+        else if constexpr (std::is_same_v<T, ChoiceTaskD>) {
+            return perLine(x.lines, answer, doc, [&](size_t i, const ChoiceLineIR& l, const JsonNode& a) {
+                return scoreChoiceLine(key.answer.choice, i, l, a, doc);
+            });
+        }
+        else if constexpr (std::is_same_v<T, MarkingTaskD>) {
+            // each marked phrase credits the first not yet credited span with that text
+            expect(answer, JsonType::Array, "Liste markierter Stellen");
+            std::vector<char>& credited = usedFlags(key.spans.size());
+            int sum = 0;
+            doc.forEachChild(answer, [&](const JsonNode& mark) {
+                expect(mark, JsonType::String, "Markierung als String");
+                for (size_t k = 0; k < key.spans.size(); ++k) {
+                    if (!credited[k] && key.spans[k].text == mark.text) {
+                        credited[k] = 1;
+                        sum += key.spans[k].points;
+                        break;
+                    }
+                }
+            });
+            return sum;
+        }
+        else {
+            // Cloze / Correction: entry k answers span k
+            expect(answer, JsonType::Array, "Liste (ein Eintrag pro Lücke)");
+            int sum = 0;
+            size_t k = 0;
+            doc.forEachChild(answer, [&](const JsonNode& a) {
+                if (k < key.spans.size() && a.type != JsonType::Null) {
+                    expect(a, JsonType::String, "Antwort als String");
+                    if (key.matchers[k].matches(a.text)) sum += key.spans[k].points;
+                }
+                ++k;
+            });
+            return sum;
+        }
+    }, *key.task);
+}
+
+void Grader::grade(char* line, size_t length, JsonDocument& doc, SubmissionScore& out) const {
+    out.id = {};
+    out.idIsString = false;
+    out.tasks.assign(keys.size(), 0);
+    out.points = 0;
+    out.error.clear();
+
+    if (!doc.parse(line, length, out.error)) {
+        out.error = "Ungültiges JSON: " + out.error;
+        return;
+    }
+    const JsonNode& root = doc.root();
+    if (root.type != JsonType::Object) {
+        out.error = "JSON-Objekt erwartet";
+        return;
+    }
+    if (const JsonNode* id = doc.member(root, "id")) {
+        if (id->type == JsonType::String || id->type == JsonType::Number) {
+            out.id = id->text;
+            out.idIsString = id->type == JsonType::String;
+        }
+    }
+
+    const JsonNode* answers = doc.member(root, "answers");
+    if (!answers || answers->type != JsonType::Array) {
+        out.error = "\"answers\" (Liste) fehlt";
+        return;
+    }
+    if (answers->size > keys.size()) {
+        out.error = "Mehr Antworten (" + std::to_string(answers->size) + ") als Aufgaben (" +
+                    std::to_string(keys.size()) + ")";
+        return;
+    }
+
+    size_t i = 0;
+    try {
+        doc.forEachChild(*answers, [&](const JsonNode& a) {
+            if (a.type != JsonType::Null) out.tasks[i] = score(keys[i], a, doc);
+            ++i;
+        });
+    } catch (const std::exception& ex) {
+        out.error = "answers[" + std::to_string(i) + "]: " + ex.what();
+        out.tasks.assign(keys.size(), 0);
+        return;
+    }
+    for (int p : out.tasks) out.points += p;
+}
@@ -0,0 +1,85 @@
+// ============================================================================
+// File: src/grading/Grader.h
+// Scores student responses against a compiled ProgramD
+// ============================================================================
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "domain/Domain.h"
+#include "grading/AnswerKey.h"
+#include "grading/JsonReader.h"
+#include "grading/TextMatch.h"
+
+// One submission per line:
+//
+//   {"id": "s42", "answers": [<task 0>, <task 1>, ...]}
+//
+// `answers` follows the task order of the program; null or a missing entry
+// scores 0. Per task kind (strings are compared exactly, except for
+// Lückentext/Textkorrektur under MatchOptions):
+//
+//   RoF            [true, false, ...]           one bool per line, 1 point each
+//   Umordnung      [["b", "a", "c"], ...]       items per line in the student's order
+//   Zuordnung      [{"Paris": "Frankreich"}, ...] left -> right per line
+//   Markierung     ["Stephen King", ...]        marked phrases, each span counts once
+//   Lueckentext    ["tolles", "fliegen"]        one entry per blank, source order
+//   Textkorrektur  ["Berlin", "fliegen"]        corrected word per span, source order
+//   Auswahl        [[0, 2], ["8 Bit"], ...]     selected options per line (index or text)
+//
+// Umordnung/Zuordnung: PartialPerCorrect gives 1 point per item on its correct
+// position / per correct pair; AllOrNothing gives pointsIfAllCorrect only if
+// every item/pair is right. PartialInOrder (Umordnung compiled with
+// --sorting-score=lis) gives 1 point per item of the longest subsequence in
+// correct relative order: "2 3 4 5 1" scores 4 instead of 0. Auswahl: a line scores the sum of the selected
+// options' points (each option once), at least 0. Marks, pairs and options
+// that are not in the key cost nothing beyond Auswahl's negative points.
+//
+// RoF and Auswahl answers are collected into bitsets and scored against the
+// packed keys of grading/AnswerKey.h (popcount / masked point sum).
+
+struct SubmissionScore {
+    std::string_view id;     // "id" as written (string value or number literal), empty if absent
+    bool idIsString = false;
+    std::vector<int> tasks;  // points per task, in program order
+    int points = 0;
+    std::string error;       // set for malformed lines (no scores then)
+};
+
+// Read-only after construction: one Grader serves all threads, each thread
+// passes its own JsonDocument. `program` must outlive the grader.
+class Grader {
+public:
+    // `match` decides how Lückentext and Textkorrektur answers are compared
+    explicit Grader(const ProgramD& program, const MatchOptions& match = {});
+
+    size_t taskCount() const { return keys.size(); }
+    int maxPoints() const { return totalMax; }
+    int maxPoints(size_t task) const { return keys[task].maxPoints; }
+
+    // Parses `line` in place (escaped strings are decoded into it) and scores it.
+    void grade(char* line, size_t length, JsonDocument& doc, SubmissionScore& out) const;
+
+private:
+    // A cloze blank, correction span or marked span, flattened in source order
+    struct Span {
+        IRString text;
+        int points = 0;
+    };
+
+    struct TaskKey {
+        const TaskD* task = nullptr;
+        std::vector<Span> spans; // Marking / Cloze / Correction only
+        std::vector<SolutionMatcher> matchers; // Cloze / Correction: one per span
+        AnswerKey answer;        // RoF / Auswahl bitsets
+        int maxPoints = 0;
+    };
+
+    int score(const TaskKey& key, const JsonNode& answer, const JsonDocument& doc) const;
+
+    std::vector<TaskKey> keys;
+    int totalMax = 0;
+};
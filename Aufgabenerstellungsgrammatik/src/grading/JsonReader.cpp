@@ -0,0 +1,252 @@
+// ============================================================================
+// File: src/grading/JsonReader.cpp
+// ============================================================================
+#include "grading/JsonReader.h"
+
+#include <charconv>
+
+bool JsonDocument::fail(const char* what) {
+    *err = std::string(what) + " bei Byte " + std::to_string(p - begin);
+    return false;
+}
+
+void JsonDocument::skipSpace() {
+    while (p < last && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) ++p;
+}
+
+bool JsonDocument::parse(char* data, size_t size, std::string& error) {
+    nodes.clear();
+    begin = p = data;
+    last = data + size;
+    err = &error;
+
+    if (!value(0)) return false;
+    skipSpace();
+    if (p != last) return fail("Unerwartetes Zeichen nach JSON-Wert");
+    return true;
+}
+
+bool JsonDocument::value(int depth) {
+    skipSpace();
+    if (p == last) return fail("Unerwartetes Zeilenende");
+    if (depth > kMaxDepth) return fail("JSON zu tief verschachtelt");
+
+    const size_t self = nodes.size();
+    nodes.emplace_back();
+
+    switch (*p) {
+    case '{':
+    case '[': {
+        const bool object = *p == '{';
+        const char close = object ? '}' : ']';
+        nodes[self].type = object ? JsonType::Object : JsonType::Array;
+        ++p;
+        skipSpace();
+        if (p < last && *p == close) {
+            ++p;
+            break;
+        }
+        for (;;) {
+            std::string_view key;
+            if (object) {
+                skipSpace();
+                if (p == last || *p != '"') return fail("Schlüssel erwartet");
+                if (!string(key)) return false;
+                skipSpace();
+                if (p == last || *p != ':') return fail("':' erwartet");
+                ++p;
+            }
+            const size_t child = nodes.size();
+            if (!value(depth + 1)) return false;
+            nodes[child].key = key;
+            ++nodes[self].size;
+
+            skipSpace();
+            if (p < last && *p == ',') {
+                ++p;
+                continue;
+            }
+            if (p < last && *p == close) {
+                ++p;
+                break;
+            }
+            return fail(object ? "',' oder '}' erwartet" : "',' oder ']' erwartet");
+        }
+        break;
+    }
+    case '"': {
+        std::string_view s;
+        if (!string(s)) return false;
+        nodes[self].type = JsonType::String;
+        nodes[self].text = s;
+        break;
+    }
+    case 't':
+        if (!literal("true")) return false;
+        nodes[self].type = JsonType::Bool;
+        nodes[self].boolean = true;
+        break;
+    case 'f':
+        if (!literal("false")) return false;
+        nodes[self].type = JsonType::Bool;
+        break;
+    case 'n':
+        if (!literal("null")) return false;
+        break;
+    default: {
+        const char* start = p;
+        if (!number()) return false;
+        nodes[self].type = JsonType::Number;
+        nodes[self].text = std::string_view(start, static_cast<size_t>(p - start));
+        break;
+    }
+    }
+
+    nodes[self].end = static_cast<uint32_t>(nodes.size());
+    return true;
+}
+
+bool JsonDocument::literal(std::string_view word) {
+    if (static_cast<size_t>(last - p) < word.size() || std::string_view(p, word.size()) != word) {
+        return fail("Ungültiger Wert");
+    }
+    p += word.size();
+    return true;
+}
+
+bool JsonDocument::number() {
+    auto digits = [&] {
+        const char* start = p;
+        while (p < last && *p >= '0' && *p <= '9') ++p;
+        return p != start;
+    };
+    if (p < last && *p == '-') ++p;
+    if (p < last && *p == '0') ++p;
+    else if (!digits()) return fail("Ungültiger Wert");
+    if (p < last && *p == '.') {
+        ++p;
+        if (!digits()) return fail("Ungültige Zahl");
+    }
+    if (p < last && (*p == 'e' || *p == 'E')) {
+        ++p;
+        if (p < last && (*p == '+' || *p == '-')) ++p;
+        if (!digits()) return fail("Ungültige Zahl");
+    }
+    return true;
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static char* putUtf8(char* w, uint32_t cp) {
+    if (cp < 0x80) {
+        *w++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *w++ = static_cast<char>(0xC0 | (cp >> 6));
+        *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *w++ = static_cast<char>(0xE0 | (cp >> 12));
+        *w++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *w++ = static_cast<char>(0xF0 | (cp >> 18));
+        *w++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *w++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return w;
+}
+
+// p at the opening quote. Decodes in place: the write cursor never passes the
+// read cursor (\uXXXX = 6 bytes -> at most 3, a surrogate pair 12 -> 4).
+bool JsonDocument::string(std::string_view& out) {
+    ++p;
+    char* const start = p;
+    char* w = p;
+
+    auto hex4 = [&](uint32_t& cp) {
+        if (last - p < 4) return false;
+        cp = 0;
+        for (int i = 0; i < 4; ++i) {
+            const int h = hexValue(p[i]);
+            if (h < 0) return false;
+            cp = cp << 4 | static_cast<uint32_t>(h);
+        }
+        p += 4;
+        return true;
+    };
+
+    while (p < last) {
+        const char c = *p;
+        if (c == '"') {
+            ++p;
+            out = std::string_view(start, static_cast<size_t>(w - start));
+            return true;
+        }
+        if (static_cast<unsigned char>(c) < 0x20) return fail("Steuerzeichen in String");
+        if (c != '\\') {
+            *w++ = *p++;
+            continue;
+        }
+
+        ++p;
+        if (p == last) break;
+        switch (*p++) {
+        case '"': *w++ = '"'; break;
+        case '\\': *w++ = '\\'; break;
+        case '/': *w++ = '/'; break;
+        case 'b': *w++ = '\b'; break;
+        case 'f': *w++ = '\f'; break;
+        case 'n': *w++ = '\n'; break;
+        case 'r': *w++ = '\r'; break;
+        case 't': *w++ = '\t'; break;
+        case 'u': {
+            uint32_t cp = 0;
+            if (!hex4(cp)) return fail("Ungültige \\u-Sequenz");
+            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                uint32_t lo = 0;
+                if (last - p < 2 || p[0] != '\\' || p[1] != 'u') return fail("Ungültiges Surrogat");
+                p += 2;
+                if (!hex4(lo) || lo < 0xDC00 || lo > 0xDFFF) return fail("Ungültiges Surrogat");
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+            } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                return fail("Ungültiges Surrogat");
+            }
+            w = putUtf8(w, cp);
+            break;
+        }
+        default:
+            return fail("Ungültige Escape-Sequenz");
+        }
+    }
+    return fail("String nicht abgeschlossen");
+}
+
+const JsonNode* JsonDocument::at(const JsonNode& array, size_t index) const {
+    if (array.type != JsonType::Array || index >= array.size) return nullptr;
+    size_t i = static_cast<size_t>(&array - nodes.data()) + 1;
+    for (size_t k = 0; k < index; ++k) i = nodes[i].end;
+    return &nodes[i];
+}
+
+const JsonNode* JsonDocument::member(const JsonNode& object, std::string_view key) const {
+    if (object.type != JsonType::Object) return nullptr;
+    size_t i = static_cast<size_t>(&object - nodes.data()) + 1;
+    for (uint32_t k = 0; k < object.size; ++k) {
+        if (nodes[i].key == key) return &nodes[i];
+        i = nodes[i].end;
+    }
+    return nullptr;
+}
+
+bool jsonToInt(const JsonNode& node, long long& out) {
+    if (node.type != JsonType::Number) return false;
+    const char* first = node.text.data();
+    const char* end = first + node.text.size();
+    const auto r = std::from_chars(first, end, out);
+    return r.ec == std::errc() && r.ptr == end;
+}
@@ -0,0 +1,77 @@
+// ============================================================================
+// File: src/grading/JsonReader.h
+// Minimal in-situ JSON reader for response lines (one document per line)
+// ============================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class JsonType : uint8_t {
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object
+};
+
+// Nodes are stored flat in document order; the children of an Array/Object
+// follow it directly and `end` skips a whole subtree.
+struct JsonNode {
+    JsonType type = JsonType::Null;
+    bool boolean = false;
+    std::string_view text; // String: decoded value, Number: the literal as written
+    std::string_view key;  // member name if the parent is an Object
+    uint32_t size = 0;     // Array/Object: number of children
+    uint32_t end = 0;      // index one past the subtree
+};
+
+// Escaped strings are decoded into the parsed buffer itself (never longer
+// than the source), so no string is copied and the views live as long as the
+// buffer. Keep one document per thread: the node vector is reused.
+class JsonDocument {
+public:
+    // false + `error` on malformed input, trailing garbage or nesting deeper than kMaxDepth
+    bool parse(char* data, size_t size, std::string& error);
+
+    const JsonNode& root() const { return nodes.front(); }
+
+    // fn(const JsonNode&) for every element/member, in order
+    template <class Fn>
+    void forEachChild(const JsonNode& parent, Fn fn) const {
+        size_t i = static_cast<size_t>(&parent - nodes.data()) + 1;
+        for (uint32_t k = 0; k < parent.size; ++k) {
+            fn(nodes[i]);
+            i = nodes[i].end;
+        }
+    }
+
+    // i-th element of an Array, nullptr if out of range
+    const JsonNode* at(const JsonNode& array, size_t index) const;
+
+    // First member called `key` of an Object, nullptr if absent
+    const JsonNode* member(const JsonNode& object, std::string_view key) const;
+
+private:
+    static constexpr int kMaxDepth = 64;
+
+    bool value(int depth);
+    bool string(std::string_view& out);
+    bool number();
+    bool literal(std::string_view word);
+    void skipSpace();
+    bool fail(const char* what);
+
+    std::vector<JsonNode> nodes;
+    char* begin = nullptr;
+    char* p = nullptr;
+    char* last = nullptr;
+    std::string* err = nullptr;
+};
+
+// Integer value of a Number node without fraction/exponent; false otherwise
+bool jsonToInt(const JsonNode& node, long long& out);
@@ -0,0 +1,219 @@
+// ============================================================================
+// File: src/grading/TextMatch.cpp
+// ============================================================================
+#include "grading/TextMatch.h"
+
+#include <algorithm>
+
+namespace {
+
+// Simple lower-case mapping for the scripts that show up in task texts
+char32_t lowerCase(char32_t c) {
+    if (c < 0x80) return c >= 'A' && c <= 'Z' ? c + 0x20 : c;
+    if (c >= 0xC0 && c <= 0xDE && c != 0xD7) return c + 0x20;
+    if (c >= 0x100 && c <= 0x17F) {
+        if (c == 0x178) return 0xFF; // Ÿ
+        const bool evenUpper = (c <= 0x137) || (c >= 0x14A && c <= 0x177);
+        const bool oddUpper = (c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E);
+        if ((evenUpper && c % 2 == 0) || (oddUpper && c % 2 == 1)) return c + 1;
+        return c;
+    }
+    if (c >= 0x391 && c <= 0x3A9 && c != 0x3A2) return c + 0x20;
+    if (c == 0x3C2) return 0x3C3; // final sigma
+    if (c >= 0x410 && c <= 0x42F) return c + 0x20;
+    if (c >= 0x400 && c <= 0x40F) return c + 0x50;
+    return c;
+}
+
+constexpr std::u32string_view kSpaces = U" \t\r\n\u00A0";
+
+bool isSpace(char32_t c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == 0xA0; }
+
+// Next code point of s[i..]; an invalid byte b decodes to U+DC00 + b, which
+// valid UTF-8 never produces.
+char32_t decodeUtf8(std::string_view s, size_t& i) {
+    const unsigned char b0 = static_cast<unsigned char>(s[i]);
+    if (b0 < 0x80) {
+        ++i;
+        return b0;
+    }
+    const size_t len = b0 < 0xC2 ? 0 : b0 < 0xE0 ? 2 : b0 < 0xF0 ? 3 : b0 <= 0xF4 ? 4 : 0;
+    if (len == 0 || i + len > s.size()) {
+        ++i;
+        return 0xDC00 + b0;
+    }
+    char32_t cp = b0 & (0x7F >> len);
+    for (size_t k = 1; k < len; ++k) {
+        const unsigned char b = static_cast<unsigned char>(s[i + k]);
+        if ((b & 0xC0) != 0x80) {
+            ++i;
+            return 0xDC00 + b0;
+        }
+        cp = cp << 6 | (b & 0x3F);
+    }
+    // overlong forms, surrogates and values past U+10FFFF count as invalid
+    static const char32_t minimum[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (cp < minimum[len] || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+        ++i;
+        return 0xDC00 + b0;
+    }
+    i += len;
+    return cp;
+}
+
+} // namespace
+
+void foldText(std::string_view text, bool fold, std::u32string& out) {
+    // every code point takes at least one byte and expands to at most two
+    // (ä/ö/ü/ß: two bytes each, ẞ: three), so text.size() bounds the output
+    out.resize(text.size());
+    char32_t* const begin = &out[0];
+    char32_t* w = begin;
+    bool pendingSpace = false;
+    for (size_t i = 0; i < text.size();) {
+        char32_t c = static_cast<unsigned char>(text[i]) < 0x80 ? static_cast<unsigned char>(text[i++])
+                                                                : decodeUtf8(text, i);
+        if (!fold) {
+            *w++ = c;
+            continue;
+        }
+        if (isSpace(c)) {
+            pendingSpace = w != begin; // runs collapse to one space, trimmed at both ends
+            continue;
+        }
+        if (pendingSpace) {
+            *w++ = U' ';
+            pendingSpace = false;
+        }
+        c = lowerCase(c);
+        switch (c) {
+        case 0xE4: *w++ = U'a'; *w++ = U'e'; break;
+        case 0xF6: *w++ = U'o'; *w++ = U'e'; break;
+        case 0xFC: *w++ = U'u'; *w++ = U'e'; break;
+        case 0xDF:
+        case 0x1E9E: *w++ = U's'; *w++ = U's'; break;
+        default: *w++ = c; break;
+        }
+    }
+    out.resize(static_cast<size_t>(w - begin));
+    if (!fold) {
+        const size_t first = out.find_first_not_of(kSpaces.data(), 0, kSpaces.size());
+        if (first == std::u32string::npos) {
+            out.clear();
+            return;
+        }
+        out.erase(out.find_last_not_of(kSpaces.data(), std::u32string::npos, kSpaces.size()) + 1);
+        out.erase(0, first);
+    }
+}
+
+EditPattern::EditPattern(std::u32string p) : pattern(std::move(p)) {
+    blocks = (pattern.size() + 63) / 64;
+    asciiPeq.assign(128 * blocks, 0);
+    zeroPeq.assign(blocks, 0);
+
+    for (char32_t c : pattern) {
+        if (c >= 0x80) otherChars.push_back(c);
+    }
+    std::sort(otherChars.begin(), otherChars.end());
+    otherChars.erase(std::unique(otherChars.begin(), otherChars.end()), otherChars.end());
+    otherPeq.assign(otherChars.size() * blocks, 0);
+
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        const char32_t c = pattern[i];
+        uint64_t* eq = c < 0x80 ? &asciiPeq[c * blocks]
+                                : &otherPeq[(std::lower_bound(otherChars.begin(), otherChars.end(), c) -
+                                             otherChars.begin()) * blocks];
+        eq[i / 64] |= uint64_t(1) << (i % 64);
+    }
+}
+
+const uint64_t* EditPattern::peq(char32_t c) const {
+    if (c < 0x80) return &asciiPeq[c * blocks];
+    const auto it = std::lower_bound(otherChars.begin(), otherChars.end(), c);
+    if (it == otherChars.end() || *it != c) return zeroPeq.data();
+    return &otherPeq[static_cast<size_t>(it - otherChars.begin()) * blocks];
+}
+
+// Column j of the DP matrix is kept as vertical deltas (+1: Pv, -1: Mv) per
+// pattern row; `score` tracks the last row, D[m][j]. Row 0 is D[0][j] = j,
+// so every column enters the first block with a horizontal delta of +1.
+// Since D[m][n] >= D[m][j] - (n - j), the scan stops once that bound passes
+// `limit`.
+int EditPattern::distance(const std::u32string& text, int limit) const {
+    const size_t m = pattern.size();
+    const size_t n = text.size();
+    if (m == 0) return static_cast<int>(n);
+    const int lengthGap = static_cast<int>(m > n ? m - n : n - m);
+    if (lengthGap > limit) return lengthGap;
+
+    const uint64_t lastHigh = uint64_t(1) << ((m - 1) % 64);
+    int score = static_cast<int>(m);
+
+    if (blocks == 1) {
+        uint64_t pv = ~uint64_t(0), mv = 0;
+        for (size_t j = 0; j < n; ++j) {
+            const uint64_t eq = peq(text[j])[0];
+            const uint64_t xv = eq | mv;
+            const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+            if (ph & lastHigh) ++score;
+            else if (mh & lastHigh) --score;
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+            if (score - static_cast<int>(n - j - 1) > limit) return limit + 1;
+        }
+        return score;
+    }
+
+    thread_local std::vector<uint64_t> pvs, mvs;
+    pvs.assign(blocks, ~uint64_t(0));
+    mvs.assign(blocks, 0);
+    for (size_t j = 0; j < n; ++j) {
+        const uint64_t* eqs = peq(text[j]);
+        int hin = 1;
+        for (size_t b = 0; b < blocks; ++b) {
+            const uint64_t high = b + 1 == blocks ? lastHigh : uint64_t(1) << 63;
+            uint64_t& pv = pvs[b];
+            uint64_t& mv = mvs[b];
+            uint64_t eq = eqs[b];
+            const uint64_t xv = eq | mv;
+            if (hin < 0) eq |= 1;
+            const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+            const int hout = (ph & high) ? 1 : (mh & high) ? -1 : 0;
+            ph <<= 1;
+            mh <<= 1;
+            if (hin < 0) mh |= 1;
+            else if (hin > 0) ph |= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+            hin = hout;
+        }
+        score += hin;
+        if (score - static_cast<int>(n - j - 1) > limit) return limit + 1;
+    }
+    return score;
+}
+
+SolutionMatcher::SolutionMatcher(std::string_view s, const MatchOptions& options)
+    : solution(s), fold(options.fold), maxEdits(options.maxEdits) {
+    if (options.exact()) return;
+    std::u32string folded;
+    foldText(s, fold, folded);
+    pattern = EditPattern(std::move(folded));
+}
+
+bool SolutionMatcher::matches(std::string_view answer) const {
+    if (!fold && maxEdits == 0) return answer == solution;
+
+    thread_local std::u32string text;
+    foldText(answer, fold, text);
+    const int limit = std::min(maxEdits, static_cast<int>(pattern.length()) - 1);
+    if (limit <= 0) return text == pattern.chars();
+    return pattern.distance(text, limit) <= limit;
+}
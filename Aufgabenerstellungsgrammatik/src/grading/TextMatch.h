@@ -0,0 +1,68 @@
+// ============================================================================
+// File: src/grading/TextMatch.h
+// Tolerant matching of free-text answers: folding + bit-parallel edit distance
+// ============================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// How a free-text answer (Lückentext blank, Textkorrektur span) is compared
+// with its solution. The default is the exact byte comparison.
+struct MatchOptions {
+    bool fold = false; // case + umlaut folding, see foldText
+    int maxEdits = 0;  // accepted Levenshtein distance (code points) after folding
+
+    bool exact() const { return !fold && maxEdits == 0; }
+};
+
+// UTF-8 -> code points, trimmed. With `fold`: lower case (Latin-1, Latin
+// Extended-A, Greek, Cyrillic), ä/ö/ü -> ae/oe/ue, ß/ẞ -> ss, so "Lückentext",
+// "LUECKENTEXT" and "lueckentext" fold to the same sequence. Invalid UTF-8
+// bytes pass through as single code points.
+void foldText(std::string_view text, bool fold, std::u32string& out);
+
+// Myers' bit-vector edit distance with the solution as the pattern: one
+// machine word per 64 code points, O(ceil(m / 64) * n) per answer.
+class EditPattern {
+public:
+    EditPattern() = default;
+    explicit EditPattern(std::u32string pattern);
+
+    size_t length() const { return pattern.size(); }
+    const std::u32string& chars() const { return pattern; }
+
+    // Levenshtein distance between the pattern and `text`, or any value
+    // > limit once it is known to exceed `limit`.
+    int distance(const std::u32string& text, int limit) const;
+
+private:
+    const uint64_t* peq(char32_t c) const;
+
+    std::u32string pattern;
+    size_t blocks = 0;
+    std::vector<uint64_t> asciiPeq;  // [c * blocks + b] for c < 128
+    std::u32string otherChars;       // non-ASCII pattern characters, sorted
+    std::vector<uint64_t> otherPeq;  // [i * blocks + b] for otherChars[i]
+    std::vector<uint64_t> zeroPeq;   // characters not in the pattern
+};
+
+// One solution, prepared once per program (see Grader). An answer matches if
+// its edit distance to the solution, both folded per `options`, is at most
+// options.maxEdits and below the solution's length (so an empty or unrelated
+// answer never matches a short solution).
+class SolutionMatcher {
+public:
+    SolutionMatcher(std::string_view solution, const MatchOptions& options);
+
+    bool matches(std::string_view answer) const;
+
+private:
+    std::string_view solution;
+    bool fold = false;
+    int maxEdits = 0;
+    EditPattern pattern;
+};
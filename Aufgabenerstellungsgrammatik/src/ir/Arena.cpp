@@ -0,0 +1,80 @@
+// ============================================================================
+// File: src/ir/Arena.cpp
+// ============================================================================
+#include "ir/Arena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+static thread_local Arena* tlsArena = nullptr;
+
+Arena* currentArena() { return tlsArena; }
+
+ArenaScope::ArenaScope(Arena& arena) : previous(tlsArena) { tlsArena = &arena; }
+
+ArenaScope::~ArenaScope() { tlsArena = previous; }
+
+void* Arena::allocate(size_t n, size_t align) {
+    // blocks come from new char[] and are aligned for any IR type
+    const size_t pad = (align - reinterpret_cast<std::uintptr_t>(cur) % align) % align;
+    if (n + pad > left) {
+        // oversized requests get their own block, the current one stays open
+        if (n > kMaxBlock / 4) {
+            blocks.emplace_back(new char[n]);
+            used += n;
+            return blocks.back().get();
+        }
+        const size_t size = nextBlock < n ? n : nextBlock;
+        blocks.emplace_back(new char[size]);
+        cur = blocks.back().get();
+        left = size;
+        if (nextBlock < kMaxBlock) nextBlock *= 2;
+    } else {
+        cur += pad;
+        left -= pad;
+    }
+    char* p = cur;
+    cur += n;
+    left -= n;
+    used += n;
+    return p;
+}
+
+void Arena::growTable() {
+    std::vector<std::string_view> old(table.empty() ? 64 : table.size() * 2);
+    old.swap(table);
+    const size_t mask = table.size() - 1;
+    for (const auto& s : old) {
+        if (s.empty()) continue;
+        size_t i = std::hash<std::string_view>{}(s) & mask;
+        while (!table[i].empty()) i = (i + 1) & mask;
+        table[i] = s;
+    }
+}
+
+std::string_view Arena::intern(std::string_view s) {
+    if (s.empty()) return {};
+
+    if (s.size() > kInternMax) {
+        char* p = static_cast<char*>(allocate(s.size()));
+        std::memcpy(p, s.data(), s.size());
+        return std::string_view(p, s.size());
+    }
+
+    // keep the load factor below 1/2
+    if ((internedCount + 1) * 2 > table.size()) growTable();
+
+    const size_t mask = table.size() - 1;
+    size_t i = std::hash<std::string_view>{}(s) & mask;
+    while (!table[i].empty()) {
+        if (table[i] == s) return table[i];
+        i = (i + 1) & mask;
+    }
+
+    char* p = static_cast<char*>(allocate(s.size()));
+    std::memcpy(p, s.data(), s.size());
+    table[i] = std::string_view(p, s.size());
+    ++internedCount;
+    return table[i];
+}
@@ -0,0 +1,114 @@
+// ============================================================================
+// File: src/ir/Arena.h
+// Per-program monotonic arena: interned IR strings + IR vector storage
+// ============================================================================
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Memory is carved out of blocks that are only freed with the arena (blocks
+// start small and double up to kMaxBlock, so a one-task file costs one block).
+// Short strings are interned, so repeated words ("Aufgabe", "Berlin", ...)
+// are stored once. Returned views/pointers stay valid for the arena's lifetime.
+// Not thread-safe: one arena per parse (ProgramIR/ProgramD keep them alive).
+class Arena {
+public:
+    Arena() = default;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Copy of `s` in the arena; identical short strings share one copy.
+    std::string_view intern(std::string_view s);
+
+    // Uninitialised storage; never freed individually.
+    void* allocate(size_t n, size_t align = 1);
+
+    size_t bytesUsed() const { return used; }
+    size_t blockCount() const { return blocks.size(); }
+
+private:
+    static constexpr size_t kInternMax = 64; // longer texts are rarely repeated
+    static constexpr size_t kFirstBlock = 2 * 1024;
+    static constexpr size_t kMaxBlock = 64 * 1024;
+
+    void growTable();
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t nextBlock = kFirstBlock;
+    char* cur = nullptr;
+    size_t left = 0;
+    size_t used = 0;
+
+    // open addressing (linear probing) over views into the blocks; one
+    // allocation per resize instead of one node per interned string
+    std::vector<std::string_view> table;
+    size_t internedCount = 0;
+};
+
+// Arenas referenced by a ProgramIR/ProgramD (one per parse or per parallel job)
+using Arenas = std::vector<std::shared_ptr<Arena>>;
+
+// Arena that IR vectors created on this thread allocate from (nullptr = heap).
+Arena* currentArena();
+
+// Makes `arena` the current arena of this thread until the scope ends.
+// The parsers open one around building IR, so every IRVector they create
+// lands in the program's arena without threading an allocator through.
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena);
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena* previous;
+};
+
+// Allocator of IRVector: picks up currentArena() when default-constructed.
+// Arena storage is released with the arena, so deallocate() is a no-op there.
+// Copies of a container go to the heap (the copy may outlive the scope).
+template <class T>
+class IRAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    IRAllocator() noexcept : arena(currentArena()) {}
+    explicit IRAllocator(Arena* a) noexcept : arena(a) {}
+    template <class U>
+    IRAllocator(const IRAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        if (arena) return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (!arena) std::allocator<T>().deallocate(p, n);
+    }
+
+    IRAllocator select_on_container_copy_construction() const { return IRAllocator(nullptr); }
+
+    template <class U>
+    bool operator==(const IRAllocator<U>& other) const noexcept { return arena == other.arena; }
+    template <class U>
+    bool operator!=(const IRAllocator<U>& other) const noexcept { return arena != other.arena; }
+
+private:
+    template <class U>
+    friend class IRAllocator;
+
+    Arena* arena;
+};
+
+template <class T>
+using IRVector = std::vector<T, IRAllocator<T>>;
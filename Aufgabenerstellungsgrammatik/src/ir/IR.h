@@ -4,22 +4,64 @@
 // ============================================================================
 #pragma once
 
+#include <cstddef>
 #include <optional>
-#include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include "ir/Arena.h"
+
+// All IR text is a view into an Arena held by the owning ProgramIR/ProgramD
+// (or into static storage for literals); the nested vectors live there too
+// (see IRAllocator). Copying the IR copies views only.
+using IRString = std::string_view;
+
+// ----------------------------
+// Task kinds
+// ----------------------------
+// Order = TaskD alternative index = kind id in the binary format.
+enum class TaskKind : unsigned char {
+    RoF,
+    Sorting,
+    Matching,
+    Marking,
+    Cloze,
+    Correction,
+    Choice,
+    Unknown
+};
+
+inline constexpr size_t kTaskKindCount = 7; // without Unknown
+
+// "type" in the JSON output (ASCII only, one spelling per kind)
+inline constexpr std::string_view kTaskKindNames[] = {
+    "RoF", "Umordnung", "Zuordnung", "Markierung", "Lueckentext", "Textkorrektur", "Auswahl", "Unknown"};
+
+// keyword in the DSL source
+inline constexpr std::string_view kTaskKindKeywords[] = {
+    "RoF", "Umordnung", "Zuordnung", "Markierung", "L\xC3\xBC" "ckentext", "Textkorrektur", "Auswahl", ""};
+
+constexpr std::string_view taskKindName(TaskKind k) { return kTaskKindNames[static_cast<size_t>(k)]; }
+constexpr std::string_view taskKindKeyword(TaskKind k) { return kTaskKindKeywords[static_cast<size_t>(k)]; }
+
+static_assert(sizeof(kTaskKindNames) / sizeof(kTaskKindNames[0]) == kTaskKindCount + 1, "one name per TaskKind");
+static_assert(sizeof(kTaskKindKeywords) / sizeof(kTaskKindKeywords[0]) == kTaskKindCount + 1, "one keyword per TaskKind");
+
 // ----------------------------
 // Common primitives
 // ----------------------------
 struct SentenceIR {
-    std::string text;   // without trailing punctuation
+    IRString text;   // without trailing punctuation
     char punctuation = '.'; // '.', '!', '?'
 };
 
 enum class ScoringModeIR {
     PartialPerCorrect, // default if no pointsIfAllCorrect given
-    AllOrNothing
+    AllOrNothing,
+    PartialInOrder     // Umordnung under --sorting-score=lis: 1 point per item of the
+                       // longest subsequence kept in correct relative order
 };
 
 struct TaskPointsIR {
@@ -46,134 +88,150 @@ struct TrueFalseTaskIR {
 struct SortingLineIR {
     SentenceIR question;
     TaskPointsIR points;
-    std::vector<std::string> items; // item values (word / number)
+    IRVector<IRString> items; // item values (word / number)
 };
 
 // ----------------------------
 // Matching
 // ----------------------------
 struct MatchingQuestionIR {
-    std::string prefix;   // endless_words
-    std::string slotA;    // word in (...)
-    std::string middle;   // endless_words
-    std::string slotB;    // word in (...)
+    IRString prefix;   // endless_words
+    IRString slotA;    // word in (...)
+    IRString middle;   // endless_words
+    IRString slotB;    // word in (...)
     char punctuation = '!';
 };
 
 struct MatchingItemIR {
-    std::string left;
-    std::string right;
+    IRString left;
+    IRString right;
 };
 
 struct MatchingLineIR {
     MatchingQuestionIR question;
     TaskPointsIR points;
-    std::vector<MatchingItemIR> pairs;
+    IRVector<MatchingItemIR> pairs;
 };
 
 // ----------------------------
 // Cloze (fill in blanks): (word,points)
 // ----------------------------
 struct ClozeBlankIR {
-    std::string solution;
+    IRString solution;
     int points = 1;
 };
 
 struct ClozePartIR {
-    std::string text; // plain text chunk (may be empty)
+    IRString text; // plain text chunk (may be empty)
     std::optional<ClozeBlankIR> blank;
 };
 
 struct ClozeSentenceIR {
-    std::vector<ClozePartIR> parts;
+    IRVector<ClozePartIR> parts;
     char punctuation = '.';
 };
 
 struct ClozeTaskIR {
     SentenceIR question;
-    std::vector<ClozeSentenceIR> sentences;
+    IRVector<ClozeSentenceIR> sentences;
 };
 
 // ----------------------------
 // Marking: ( ... )[points] or ( ... )[correction,points]
 // ----------------------------
 struct MarkedSpanIR {
-    std::string markedText;
-    std::optional<std::string> correction;
+    IRString markedText;
+    std::optional<IRString> correction;
     int points = 1;
 };
 
 struct MarkingPartIR {
-    std::string text; // plain text
+    IRString text; // plain text
     std::optional<MarkedSpanIR> mark;
 };
 
 struct MarkingSentenceIR {
-    std::vector<MarkingPartIR> parts;
+    IRVector<MarkingPartIR> parts;
     char punctuation = '.';
 };
 
 struct MarkingTaskIR {
     SentenceIR question;
-    std::vector<MarkingSentenceIR> sentences;
+    IRVector<MarkingSentenceIR> sentences;
 };
 
 // ----------------------------
 // Correction: (wrong)[correct,points]
 // ----------------------------
 struct CorrectionSpanIR {
-    std::string wrong;
-    std::string correct;
+    IRString wrong;
+    IRString correct;
     int points = 1;
 };
 
 struct CorrectionPartIR {
-    std::string text;
+    IRString text;
     std::optional<CorrectionSpanIR> corr;
 };
 
 struct CorrectionSentenceIR {
-    std::vector<CorrectionPartIR> parts;
+    IRVector<CorrectionPartIR> parts;
     char punctuation = '.';
 };
 
 struct CorrectionTaskIR {
     SentenceIR question;
-    std::vector<CorrectionSentenceIR> sentences;
+    IRVector<CorrectionSentenceIR> sentences;
 };
 
 // ----------------------------
 // Choice (single/multiple)
 // ----------------------------
 struct ChoiceOptionIR {
-    std::string text;
+    IRString text;
     int points = 0;
     bool isCorrect = false;
 };
 
 struct ChoiceLineIR {
     SentenceIR question;
-    std::vector<ChoiceOptionIR> options;
+    IRVector<ChoiceOptionIR> options;
 };
 
 // ----------------------------
 // Program/Tasks
 // ----------------------------
 struct TaskIR {
-    std::string header;
-    std::string type; // "RoF","Umordnung","Zuordnung","Markierung","Lückentext","Textkorrektur","Auswahl"
+    IRString header;
+    TaskKind kind = TaskKind::Unknown; // set from the keyword token by the parsers
 
-    std::vector<TrueFalseTaskIR> rof;
-    std::vector<SortingLineIR> sorting;
-    std::vector<MatchingLineIR> matching;
+    IRVector<TrueFalseTaskIR> rof;
+    IRVector<SortingLineIR> sorting;
+    IRVector<MatchingLineIR> matching;
 
     std::optional<MarkingTaskIR> marking;
     std::optional<ClozeTaskIR> cloze;
     std::optional<CorrectionTaskIR> correction;
 
-    std::vector<ChoiceLineIR> choice;
+    IRVector<ChoiceLineIR> choice;
 };
 
 struct ProgramIR {
+    // Declared before `tasks`, so the tasks are destroyed first: destroying
+    // an IRVector reads the arena memory it lives in.
+    Arenas arenas; // storage behind the strings and vectors in `tasks`
     std::vector<TaskIR> tasks;
+
+    ProgramIR() = default;
+    ProgramIR(const ProgramIR&) = default;
+    ProgramIR(ProgramIR&&) = default;
+    ProgramIR& operator=(const ProgramIR&) = delete;
+
+    // Member-wise assignment would release the old arenas before the old tasks
+    ProgramIR& operator=(ProgramIR&& other) noexcept {
+        ProgramIR old(std::move(*this)); // dies at return, tasks before arenas
+        arenas = std::move(other.arenas);
+        tasks = std::move(other.tasks);
+        return *this;
+    }
 };
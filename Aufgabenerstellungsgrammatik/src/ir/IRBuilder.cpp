@@ -5,13 +5,11 @@
 
 #include <any>
 #include <cctype>
-#include <sstream>
 #include <stdexcept>
 #include <utility>
 
 using Parser = AufgabenerstellungsgrammatikParser;
 using std::any;
-using std::any_cast;
 
 int IRBuilder::parseIntStrict(const std::string& s) {
     try {
@@ -24,98 +22,105 @@ int IRBuilder::parseIntStrict(const std::string& s) {
     }
 }
 
-bool IRBuilder::isWordishToken(int tokenType) {
-    return tokenType == AufgabenerstellungsgrammatikLexer::LETTERS ||
-           tokenType == AufgabenerstellungsgrammatikLexer::NUMBER;
+TaskKind IRBuilder::taskKindFromToken(size_t tokenType) {
+    switch (tokenType) {
+    case AufgabenerstellungsgrammatikLexer::RIGHT_OR_FALSE:  return TaskKind::RoF;
+    case AufgabenerstellungsgrammatikLexer::SORTING:         return TaskKind::Sorting;
+    case AufgabenerstellungsgrammatikLexer::MATCHING:        return TaskKind::Matching;
+    case AufgabenerstellungsgrammatikLexer::MARKING:         return TaskKind::Marking;
+    case AufgabenerstellungsgrammatikLexer::CLOZE_TEXT:      return TaskKind::Cloze;
+    case AufgabenerstellungsgrammatikLexer::CORRECTION_TEXT: return TaskKind::Correction;
+    case AufgabenerstellungsgrammatikLexer::CHOICE_TEXT:     return TaskKind::Choice;
+    default:                                                 return TaskKind::Unknown;
+    }
 }
 
-bool IRBuilder::isPunctToken(int tokenType) {
-    return tokenType == AufgabenerstellungsgrammatikLexer::PUNCTUATION;
-}
+namespace {
+
+using Lexer = AufgabenerstellungsgrammatikLexer;
 
-bool IRBuilder::isNoSpaceLeftToken(int tokenType) {
-    // no space BEFORE these tokens
-    return isPunctToken(tokenType) ||
-           tokenType == AufgabenerstellungsgrammatikLexer::CONNECTION || // ',' only
-           tokenType == AufgabenerstellungsgrammatikLexer::T__1 || // ')'
-           tokenType == AufgabenerstellungsgrammatikLexer::T__6 || // ']'
-           tokenType == AufgabenerstellungsgrammatikLexer::T__3 || // ';'
-           tokenType == AufgabenerstellungsgrammatikLexer::T__5 || // '/'
-           tokenType == AufgabenerstellungsgrammatikLexer::T__7;   // ',' literal in grammar likely ends up CONNECTION; keep safe
+// token types are 1..NEWLINE; anything else (EOF) never gets a blank
+constexpr size_t kTokenTypes = Lexer::NEWLINE + 1;
+
+constexpr bool isWordish(size_t tokenType) {
+    return tokenType == Lexer::LETTERS || tokenType == Lexer::NUMBER;
 }
 
-bool IRBuilder::isNoSpaceRightToken(int tokenType) {
-    // no space AFTER these tokens
-    return tokenType == AufgabenerstellungsgrammatikLexer::T__0 || // '('
-           tokenType == AufgabenerstellungsgrammatikLexer::T__4 || // '-'
-           tokenType == AufgabenerstellungsgrammatikLexer::T__2 || // ':'
-           tokenType == AufgabenerstellungsgrammatikLexer::T__5 || // '/'
-           tokenType == AufgabenerstellungsgrammatikLexer::T__4 || // '-'
-           tokenType == AufgabenerstellungsgrammatikLexer::T__5 || // '/'
-           tokenType == AufgabenerstellungsgrammatikLexer::T__6;   // '['
+// textJoin spacing as a [prev][cur] table. Only these pairs get a blank,
+// everything else (punctuation, brackets, '/', ',' ...) is glued:
+//   word word (except NUMBER NUMBER: "1" "6" -> "16"), word '(' ("ist ("), ')' word (") zu")
+struct SpaceTable {
+    bool blank[kTokenTypes][kTokenTypes] = {};
+};
+
+constexpr SpaceTable makeSpaceTable() {
+    SpaceTable t;
+    for (size_t prev = 0; prev < kTokenTypes; ++prev) {
+        for (size_t cur = 0; cur < kTokenTypes; ++cur) {
+            bool blank = false;
+            if (prev == Lexer::NUMBER && cur == Lexer::NUMBER) blank = false;
+            else if (isWordish(prev) && isWordish(cur)) blank = true;
+            else if (isWordish(prev) && cur == Lexer::T__0) blank = true; // '('
+            else if (prev == Lexer::T__1 && isWordish(cur)) blank = true; // ')'
+            t.blank[prev][cur] = blank;
+        }
+    }
+    return t;
 }
 
-std::string IRBuilder::textJoin(antlr4::ParserRuleContext* ctx, bool keepNewlines) const {
-    if (!ctx || !tokens || !ctx->getStart() || !ctx->getStop()) return "";
+constexpr SpaceTable kSpace = makeSpaceTable();
 
-    int a = ctx->getStart()->getTokenIndex();
-    int b = ctx->getStop()->getTokenIndex();
-    if (a < 0 || b < a) return "";
+static_assert(kSpace.blank[Lexer::LETTERS][Lexer::NUMBER], "word word");
+static_assert(!kSpace.blank[Lexer::NUMBER][Lexer::NUMBER], "digits are joined");
+static_assert(!kSpace.blank[Lexer::LETTERS][Lexer::PUNCTUATION], "no blank before punctuation");
 
-    std::ostringstream out;
-    antlr4::Token* prev = nullptr;
+} // namespace
 
-    for (int i = a; i <= b; ++i) {
-        auto* t = tokens->get(i);
-        if (!t) continue;
+std::string_view IRBuilder::textJoin(antlr4::ParserRuleContext* ctx, bool keepNewlines) const {
+    joinBuffer.clear();
+    if (!ctx || !tokens || !ctx->getStart() || !ctx->getStop()) return {};
+
+    const size_t a = ctx->getStart()->getTokenIndex();
+    const size_t b = ctx->getStop()->getTokenIndex();
+    if (a == antlr4::INVALID_INDEX || b == antlr4::INVALID_INDEX || b < a) return {};
+
+    if (sliceSource) {
+        // the joined text is the source span minus blanks, plus at most one per token
+        const size_t from = ctx->getStart()->getStartIndex();
+        const size_t to = ctx->getStop()->getStopIndex();
+        if (to >= from) joinBuffer.reserve(to - from + 1 + (b - a));
+    }
 
-        int tt = t->getType();
+    size_t prev = 0; // 0 = no previous token on this line
+    for (size_t i = a; i <= b; ++i) {
+        antlr4::Token* t = tokens->get(i);
+        if (!t) continue;
 
-        if (tt == AufgabenerstellungsgrammatikLexer::NEWLINE) {
-            if (keepNewlines) out << "\n";
-            prev = nullptr;
+        const size_t tt = t->getType();
+        if (tt == Lexer::NEWLINE) {
+            if (keepNewlines) joinBuffer += '\n';
+            prev = 0;
             continue;
         }
 
-        const std::string cur = t->getText();
-
-        if (prev) {
-            int pt = prev->getType();
+        if (prev < kTokenTypes && tt < kTokenTypes && kSpace.blank[prev][tt]) joinBuffer += ' ';
 
-            // join digits: NUMBER followed by NUMBER => no space ("1""6" -> "16")
-            if (pt == AufgabenerstellungsgrammatikLexer::NUMBER && tt == AufgabenerstellungsgrammatikLexer::NUMBER) {
-                // no space
-            }
-            // default word spacing
-            else if (isWordishToken(pt) && isWordishToken(tt)) {
-                out << ' ';
-            }
-            // space between word and '('? (want "ist (" not "ist(")
-            else if (isWordishToken(pt) && tt == AufgabenerstellungsgrammatikLexer::T__0) { // '('
-                out << ' ';
-            }
-            // space between ')' and word? (want ") zu")
-            else if (pt == AufgabenerstellungsgrammatikLexer::T__1 && isWordishToken(tt)) { // ')'
-                out << ' ';
-            }
-            // prevent spaces around punctuation/brackets
-            else if (isNoSpaceLeftToken(tt) || isNoSpaceRightToken(pt)) {
-                // no space
-            }
-            // conservative: space between wordish and wordish handled; else keep none
+        if (sliceSource) {
+            const size_t start = t->getStartIndex();
+            joinBuffer.append(source.data() + start, t->getStopIndex() + 1 - start);
+        } else {
+            joinBuffer += t->getText();
         }
-
-        out << cur;
-        prev = t;
+        prev = tt;
     }
 
-    return out.str();
+    return joinBuffer;
 }
 
-std::string IRBuilder::readEndlessWords(Parser::Endless_wordsContext* ew) const {
-    if (!ew) return "";
+IRString IRBuilder::readEndlessWords(Parser::Endless_wordsContext* ew) const {
+    if (!ew) return {};
     // endless_words has no punctuation; keepNewlines=false
-    return textJoin(ew, false);
+    return arena.intern(textJoin(ew, false));
 }
 
 SentenceIR IRBuilder::readSentence(Parser::SentenceContext* s) const {
@@ -134,38 +139,36 @@ SentenceIR IRBuilder::readSentence(Parser::SentenceContext* s) const {
 }
 
 // prog: tasks NEWLINE? EOF;
-any IRBuilder::visitProg(Parser::ProgContext* ctx) {
-    ProgramIR prog;
-
+void IRBuilder::buildProgram(Parser::ProgContext* ctx, ProgramIR& prog) {
+    ArenaScope scope(arena);
     auto* tasksCtx = ctx->tasks();
-    if (!tasksCtx) return prog;
+    if (!tasksCtx) return;
 
-    for (auto* td : tasksCtx->task_definition()) {
-        TaskIR t = any_cast<TaskIR>(visitTask_definition(td));
-        prog.tasks.push_back(std::move(t));
+    const auto defs = tasksCtx->task_definition();
+    prog.tasks.reserve(prog.tasks.size() + defs.size());
+    for (auto* td : defs) {
+        buildTask(td, prog.tasks.emplace_back()); // built in place, never copied
     }
-
-    return prog;
 }
 
 // task_definition: endless_words task;
-any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
-    TaskIR task;
-
+void IRBuilder::buildTask(Parser::Task_definitionContext* ctx, TaskIR& task) {
+    ArenaScope scope(arena);
+    task = TaskIR{}; // re-created inside the scope so its vectors use the arena
     task.header = readEndlessWords(ctx->endless_words());
 
     auto* tctx = ctx->task();
-    if (!tctx) {
-        task.type = "Unknown";
-        return task;
+    if (!tctx) return; // kind stays Unknown
+
+    // task: '(' KEYWORD ')' ':' ...  -> the kind comes straight from the keyword token
+    if (auto* kw = tctx->children.size() > 1 ? dynamic_cast<antlr4::tree::TerminalNode*>(tctx->children[1]) : nullptr) {
+        task.kind = taskKindFromToken(kw->getSymbol()->getType());
     }
 
     // ----------------------------
     // RoF
     // ----------------------------
-    if (tctx->RIGHT_OR_FALSE()) {
-        task.type = "RoF";
-
+    if (task.kind == TaskKind::RoF) {
         for (auto* tf : tctx->true_false_task()) {
             TrueFalseTaskIR line;
             line.question = readSentence(tf->question_or_statement()->sentence());
@@ -184,7 +187,7 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
                         SentenceIR rs;
                         rs.text = readEndlessWords(ans->reason()->endless_words());
                         rs.punctuation = '.'; // unknown (error branch), default
-                        line.answer.reason = rs;
+                        line.answer.reason = std::move(rs);
                     }
                 }
             }
@@ -192,15 +195,13 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
             task.rof.push_back(std::move(line));
         }
 
-        return task;
+        return;
     }
 
     // ----------------------------
     // Sorting
     // ----------------------------
-    if (tctx->SORTING()) {
-        task.type = "Umordnung";
-
+    if (task.kind == TaskKind::Sorting) {
         for (auto* s : tctx->sorting_task()) {
             SortingLineIR line;
             line.question = readSentence(s->question_or_statement()->sentence());
@@ -214,21 +215,19 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
             }
 
             for (auto* it : s->item()) {
-                if (auto* w = it->word()) line.items.push_back(w->getText());
+                if (auto* w = it->word()) line.items.push_back(arena.intern(w->getText()));
             }
 
             task.sorting.push_back(std::move(line));
         }
 
-        return task;
+        return;
     }
 
     // ----------------------------
     // Matching
     // ----------------------------
-    if (tctx->MATCHING()) {
-        task.type = "Zuordnung";
-
+    if (task.kind == TaskKind::Matching) {
         for (auto* m : tctx->matching_task()) {
             MatchingLineIR line;
 
@@ -236,9 +235,9 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
             // endless_words '(' word ')' endless_words '(' word')' PUNCTUATION;
             auto* mq = m->matching_question_or_statement();
             line.question.prefix = readEndlessWords(mq->endless_words(0));
-            line.question.slotA  = mq->word(0)->getText();
+            line.question.slotA  = arena.intern(mq->word(0)->getText());
             line.question.middle = readEndlessWords(mq->endless_words(1));
-            line.question.slotB  = mq->word(1)->getText();
+            line.question.slotB  = arena.intern(mq->word(1)->getText());
             line.question.punctuation = mq->PUNCTUATION()->getText()[0];
 
             if (m->positive_task_point()) {
@@ -252,23 +251,21 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
             for (auto* mi : m->matching_item()) {
                 MatchingItemIR p;
                 auto ws = mi->word();
-                p.left  = ws.size() >= 1 ? ws[0]->getText() : "";
-                p.right = ws.size() >= 2 ? ws[1]->getText() : "";
+                p.left  = ws.size() >= 1 ? arena.intern(ws[0]->getText()) : IRString{};
+                p.right = ws.size() >= 2 ? arena.intern(ws[1]->getText()) : IRString{};
                 line.pairs.push_back(std::move(p));
             }
 
             task.matching.push_back(std::move(line));
         }
 
-        return task;
+        return;
     }
 
     // ----------------------------
     // Marking
     // ----------------------------
-    if (tctx->MARKING()) {
-        task.type = "Markierung";
-
+    if (task.kind == TaskKind::Marking) {
         MarkingTaskIR out;
         auto* mt = tctx->marking_task();
         out.question = readSentence(mt->question_or_statement()->sentence());
@@ -316,8 +313,8 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
                     mark.points = parseIntStrict(mp->positive_task_point()->getText());
 
                     MarkingPartIR pm;
-                    pm.text.clear();
-                    pm.mark = mark;
+                    pm.text = {};
+                    pm.mark = std::move(mark);
                     s.parts.push_back(std::move(pm));
 
                     // trailing endless_words? after this mark (if present)
@@ -345,15 +342,13 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
         }
 
         task.marking = std::move(out);
-        return task;
+        return;
     }
 
     // ----------------------------
     // Cloze
     // ----------------------------
-    if (tctx->CLOZE_TEXT()) {
-        task.type = "Lückentext";
-
+    if (task.kind == TaskKind::Cloze) {
         ClozeTaskIR out;
         auto* ct = tctx->cloze_task();
         out.question = readSentence(ct->question_or_statement()->sentence());
@@ -380,12 +375,12 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
 
                     // cloze_word: '(' word ',' positive_task_point ')'
                     ClozeBlankIR b;
-                    b.solution = cw->word()->getText();
+                    b.solution = arena.intern(cw->word()->getText());
                     b.points = parseIntStrict(cw->positive_task_point()->getText());
 
                     ClozePartIR pb;
-                    pb.text.clear();
-                    pb.blank = b;
+                    pb.text = {};
+                    pb.blank = std::move(b);
                     s.parts.push_back(std::move(pb));
 
                     if (ewIdx < cs->endless_words().size()) {
@@ -412,15 +407,13 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
         }
 
         task.cloze = std::move(out);
-        return task;
+        return;
     }
 
     // ----------------------------
     // Correction
     // ----------------------------
-    if (tctx->CORRECTION_TEXT()) {
-        task.type = "Textkorrektur";
-
+    if (task.kind == TaskKind::Correction) {
         CorrectionTaskIR out;
         auto* ct = tctx->correction_task();
         out.question = readSentence(ct->question_or_statement()->sentence());
@@ -447,13 +440,13 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
 
                     // correction_word: '(' word ')' ('[' word ',' positive_task_point ']');
                     CorrectionSpanIR c;
-                    c.wrong = cw->word(0)->getText();
-                    c.correct = cw->word(1)->getText();
+                    c.wrong = arena.intern(cw->word(0)->getText());
+                    c.correct = arena.intern(cw->word(1)->getText());
                     c.points = parseIntStrict(cw->positive_task_point()->getText());
 
                     CorrectionPartIR pc;
-                    pc.text.clear();
-                    pc.corr = c;
+                    pc.text = {};
+                    pc.corr = std::move(c);
                     s.parts.push_back(std::move(pc));
 
                     if (ewIdx < cs->endless_words().size()) {
@@ -479,15 +472,13 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
         }
 
         task.correction = std::move(out);
-        return task;
+        return;
     }
 
     // ----------------------------
     // Choice
     // ----------------------------
-    if (tctx->CHOICE_TEXT()) {
-        task.type = "Auswahl";
-
+    if (task.kind == TaskKind::Choice) {
         for (auto* ch : tctx->choice_task()) {
             ChoiceLineIR line;
             line.question = readSentence(ch->question_or_statement()->sentence());
@@ -519,9 +510,19 @@ any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
             task.choice.push_back(std::move(line));
         }
 
-        return task;
+        return;
     }
+}
+
+// ---- visitor shims (std::any boxing; the compiler uses buildProgram/buildTask) ----
+any IRBuilder::visitProg(Parser::ProgContext* ctx) {
+    ProgramIR prog;
+    buildProgram(ctx, prog);
+    return any(std::move(prog));
+}
 
-    task.type = "Unknown";
-    return task;
+any IRBuilder::visitTask_definition(Parser::Task_definitionContext* ctx) {
+    TaskIR task;
+    buildTask(ctx, task);
+    return any(std::move(task));
 }
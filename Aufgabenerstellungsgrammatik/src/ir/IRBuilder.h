@@ -5,6 +5,7 @@
 
 #include <any>
 #include <string>
+#include <string_view>
 
 #include "antlr4-runtime.h"
 #include "AufgabenerstellungsgrammatikBaseVisitor.h"
@@ -15,26 +16,41 @@
 
 class IRBuilder : public AufgabenerstellungsgrammatikBaseVisitor {
 public:
-    IRBuilder(const std::string& sourceText, antlr4::CommonTokenStream* tokenStream)
-        : source(sourceText), tokens(tokenStream) {}
-
+    // `sourceText` is only viewed; it must outlive the builder.
+    // All IR strings and vectors are allocated from `irArena` (see Arena.h).
+    // `byteOffsets`: token start/stop indices are byte offsets into `sourceText`
+    // (NativeTokenSource), so token text is sliced from it. The generated lexer
+    // reports code point indices; then every token's getText() is used.
+    IRBuilder(std::string_view sourceText, antlr4::CommonTokenStream* tokenStream, Arena& irArena,
+              bool byteOffsets = false)
+        : source(sourceText), tokens(tokenStream), arena(irArena), sliceSource(byteOffsets) {}
+
+    IRBuilder(const IRBuilder&) = delete;
+    IRBuilder& operator=(const IRBuilder&) = delete;
+
+    // Typed build API: appends/fills in place, task payloads are only ever moved.
+    void buildProgram(AufgabenerstellungsgrammatikParser::ProgContext* ctx, ProgramIR& out);
+    void buildTask(AufgabenerstellungsgrammatikParser::Task_definitionContext* ctx, TaskIR& out);
+
+    // Visitor interface kept as a thin shim over the typed API (boxes the result in std::any)
     std::any visitProg(AufgabenerstellungsgrammatikParser::ProgContext* ctx) override;
     std::any visitTask_definition(AufgabenerstellungsgrammatikParser::Task_definitionContext* ctx) override;
 
 private:
-    std::string source;
+    std::string_view source;
     antlr4::CommonTokenStream* tokens = nullptr;
+    Arena& arena;
+    bool sliceSource = false;
+    mutable std::string joinBuffer; // reused by textJoin
 
     // ---- token-based reconstruction helpers ----
-    std::string textJoin(antlr4::ParserRuleContext* ctx, bool keepNewlines) const;
-    static bool isWordishToken(int tokenType);
-    static bool isPunctToken(int tokenType);
-    static bool isNoSpaceLeftToken(int tokenType);  // punctuation, ')', ']', '/', ',', etc.
-    static bool isNoSpaceRightToken(int tokenType); // '(' , '[' , etc.
+    // Tokens of ctx joined with the spacing rules; valid until the next call
+    std::string_view textJoin(antlr4::ParserRuleContext* ctx, bool keepNewlines) const;
 
     static int parseIntStrict(const std::string& s);
+    static TaskKind taskKindFromToken(size_t tokenType);
 
     // ---- grammar-level helpers ----
     SentenceIR readSentence(AufgabenerstellungsgrammatikParser::SentenceContext* s) const;
-    std::string readEndlessWords(AufgabenerstellungsgrammatikParser::Endless_wordsContext* ew) const;
+    IRString readEndlessWords(AufgabenerstellungsgrammatikParser::Endless_wordsContext* ew) const;
 };
@@ -1,125 +1,288 @@
 #include <iostream>
-#include <fstream>
+#include <stdexcept>
 #include <string>
-#include <any>
-#include <sstream>
+#include <vector>
 
-#include "antlr4-runtime.h"
-#include "AufgabenerstellungsgrammatikLexer.h"
-#include "AufgabenerstellungsgrammatikParser.h"
+#include "domain/DomainBinary.h"
+#include "domain/DomainJson.h"
+#include "driver/Batch.h"
+#include "driver/Compiler.h"
+#include "driver/Grade.h"
+#include "driver/Recover.h"
+#include "driver/Server.h"
+#include "driver/SplitCompile.h"
+#include "driver/Verify.h"
+#include "driver/Watch.h"
 
-#include "ir/IRBuilder.h"
-#include "ir/IR.h"
+// "-j N" / "-jN"; advances i past the value
+static bool readJobsFlag(int argc, char* argv[], int& i, size_t& jobs) {
+    const std::string arg = argv[i];
+    try {
+        if (arg == "-j" && i + 1 < argc) {
+            jobs = std::stoul(argv[++i]);
+            return true;
+        }
+        if (arg.rfind("-j", 0) == 0 && arg.size() > 2) {
+            jobs = std::stoul(arg.substr(2));
+            return true;
+        }
+    } catch (const std::exception&) {
+        throw std::runtime_error("Ungültige Thread-Anzahl: " + arg);
+    }
+    return false;
+}
 
-#include "domain/Domain.h"
-#include "domain/DomainConvert.h"
-#include "domain/DomainJson.h"
+// "--lexer=native|antlr"
+static bool readLexerFlag(const std::string& arg, CompilerOptions& opts) {
+    if (arg.rfind("--lexer=", 0) != 0) return false;
+    const std::string v = arg.substr(8);
+    if (v == "native") opts.lexer = LexerKind::Native;
+    else if (v == "antlr") opts.lexer = LexerKind::Antlr;
+    else throw std::runtime_error("Unbekannter Lexer: " + v);
+    return true;
+}
 
-using namespace antlr4;
+// "--frontend=native|antlr"
+static bool readFrontendFlag(const std::string& arg, CompilerOptions& opts) {
+    if (arg.rfind("--frontend=", 0) != 0) return false;
+    const std::string v = arg.substr(11);
+    if (v == "native") opts.frontend = FrontendKind::Native;
+    else if (v == "antlr") opts.frontend = FrontendKind::Antlr;
+    else throw std::runtime_error("Unbekanntes Frontend: " + v);
+    return true;
+}
 
-#include "antlr4-runtime.h"
-#include <iostream>
-#include <string>
+// "--format=json|json-compact|bin"
+static bool readFormatFlag(const std::string& arg, CompilerOptions& opts) {
+    if (arg.rfind("--format=", 0) != 0) return false;
+    const std::string v = arg.substr(9);
+    if (v == "json") opts.format = OutputFormat::Json;
+    else if (v == "json-compact") opts.format = OutputFormat::JsonCompact;
+    else if (v == "bin") opts.format = OutputFormat::Bin;
+    else throw std::runtime_error("Unbekanntes Ausgabeformat: " + v);
+    return true;
+}
 
-static void dumpTokens(antlr4::CommonTokenStream& tokens) {
-    tokens.fill();
-    for (auto* t : tokens.getTokens()) {
-        std::string txt = t->getText();
+// "--sorting-score=position|lis"
+static bool readSortingFlag(const std::string& arg, CompilerOptions& opts) {
+    if (arg.rfind("--sorting-score=", 0) != 0) return false;
+    const std::string v = arg.substr(16);
+    if (v == "position") opts.sortingScore = SortingScore::Position;
+    else if (v == "lis") opts.sortingScore = SortingScore::InOrder;
+    else throw std::runtime_error("Unbekannte Umordnungs-Bewertung: " + v);
+    return true;
+}
 
-        // newlines sichtbar machen (ASCII-safe)
-        for (char& c : txt) {
-            if (c == '\n') c = '#'; // oder lass es ganz weg
-        }
+// "--cache-mb <n>" (--serve task cache budget, 0 = unbounded)
+static size_t readMegabytes(const std::string& v) {
+    try {
+        size_t used = 0;
+        const unsigned long mb = std::stoul(v, &used);
+        if (used == v.size() && v[0] != '-') return static_cast<size_t>(mb) * 1024 * 1024;
+    } catch (const std::exception&) {
+    }
+    throw std::runtime_error("Ungültige Cache-Größe (MB): " + v);
+}
 
-        std::cout
-            << "[" << t->getTokenIndex() << "] "
-            << "type=" << t->getType()
-            << " line=" << t->getLine()
-            << ":" << t->getCharPositionInLine()
-            << " start=" << t->getStartIndex()
-            << " stop=" << t->getStopIndex()
-            << " text='" << txt << "'\n";
+// "--debounce <ms>"
+static int readMillis(const std::string& v) {
+    try {
+        size_t used = 0;
+        const int ms = std::stoi(v, &used);
+        if (used == v.size() && ms >= 0) return ms;
+    } catch (const std::exception&) {
     }
+    throw std::runtime_error("Ungültige Wartezeit (ms): " + v);
 }
 
+// "--max-edits <n>"
+static int readEdits(const std::string& v) {
+    try {
+        size_t used = 0;
+        const int n = std::stoi(v, &used);
+        if (used == v.size() && n >= 0) return n;
+    } catch (const std::exception&) {
+    }
+    throw std::runtime_error("Ungültige Anzahl Tippfehler: " + v);
+}
+
+// --decode <input.bin> <output.json>: binary domain file back to pretty JSON
+static int runDecode(const std::string& inputPath, const std::string& outputPath) {
+    try {
+        writeDomainToFile(readDomainBinaryFile(inputPath), outputPath);
+    } catch (const std::exception& ex) {
+        std::cerr << "Fehler beim Dekodieren: " << ex.what() << "\n";
+        return 1;
+    }
+    std::cerr << "Domain JSON geschrieben: " << outputPath << "\n";
+    return 0;
+}
+
+static int usage(const char* exe) {
+    std::cerr << "Usage: " << exe
+              << " [-j N] [--lexer=native|antlr] [--frontend=native|antlr]"
+                 " [--format=json|json-compact|bin] [--sorting-score=position|lis] [--cache <dir>] [--stats]"
+                 " [--dump-tokens <file.jsonl|file.bin|->] [--recover <report.json|->]"
+                 " <input.dsl.txt> <output.json>\n"
+              << "       " << exe
+              << " --batch [-j N] [--lexer=native|antlr] [--frontend=native|antlr]"
+                 " [--format=json|json-compact|bin] [--sorting-score=position|lis] [--cache <dir>]"
+                 " --out <dir> <input|dir|glob|@list>...\n"
+              << "       " << exe
+              << " --serve [-j N] [--lexer=native|antlr] [--frontend=native|antlr]"
+                 " [--format=json|json-compact|bin] [--sorting-score=position|lis] [--socket <path>]"
+                 " [--cache-mb <n>]\n"
+              << "       " << exe
+              << " --watch [--lexer=native|antlr] [--frontend=native|antlr]"
+                 " [--format=json|json-compact|bin] [--sorting-score=position|lis] [--cache <dir>]"
+                 " [--debounce <ms>] --out <dir> <dir>\n"
+              << "       " << exe
+              << " --grade [-j N] [--lexer=native|antlr] [--frontend=native|antlr] [--sorting-score=position|lis]"
+                 " [--fold] [--max-edits <n>]"
+                 " <program.dsl.txt|program.bin> <responses.jsonl|-> <scores.jsonl|->\n"
+              << "       " << exe
+              << " --verify <input|dir|glob|@list>...\n"
+              << "       " << exe
+              << " --decode <input.bin> <output.json>\n";
+    return 1;
+}
 
 int main(int argc, char* argv[]) {
     std::cerr << "[aufgaben_dsl] started\n";
 
-    // Usage: aufgaben_dsl <input.dsl.txt> <output.json>
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0]
-                  << " <input.dsl.txt> <output.json>\n";
-        return 1;
+    // Usage: aufgaben_dsl [-j N] [--lexer=...] [--frontend=...] [--format=...] [--sorting-score=...] [--cache <dir>] [--stats] [--dump-tokens <file>] [--recover <report>] <input.dsl.txt> <output.json>
+    //        aufgaben_dsl --batch [-j N] [--lexer=...] [--frontend=...] [--format=...] [--sorting-score=...] [--cache <dir>] --out <dir> <input|dir|glob|@list>...
+    //        aufgaben_dsl --serve [-j N] [--lexer=...] [--frontend=...] [--format=...] [--sorting-score=...] [--socket <path>] [--cache-mb <n>]
+    //        aufgaben_dsl --watch [--lexer=...] [--frontend=...] [--format=...] [--sorting-score=...] [--cache <dir>] [--debounce <ms>] --out <dir> <dir>
+    //        aufgaben_dsl --grade [-j N] [--lexer=...] [--frontend=...] [--sorting-score=...] [--fold] [--max-edits <n>] <program.dsl.txt|program.bin> <responses.jsonl|-> <scores.jsonl|->
+    //        aufgaben_dsl --verify <input|dir|glob|@list>...
+    //        aufgaben_dsl --decode <input.bin> <output.json>
+    const std::string mode = argc >= 2 ? argv[1] : "";
+    const bool batchMode = mode == "--batch";
+    const bool serveMode = mode == "--serve";
+    const bool watchMode = mode == "--watch";
+    const bool gradeMode = mode == "--grade";
+    const bool singleMode = !batchMode && !serveMode && !watchMode && !gradeMode;
+    const bool verifyMode = mode == "--verify";
+
+    if (mode == "--decode") {
+        if (argc != 4) return usage(argv[0]);
+        return runDecode(argv[2], argv[3]);
     }
 
-    const std::string inputPath  = argv[1];
-    const std::string outputPath = argv[2];
+    if (verifyMode) {
+        std::vector<std::string> specs(argv + 2, argv + argc);
+        if (specs.empty()) return usage(argv[0]);
+        return runVerify(specs);
+    }
 
-    // ------------------------------------------------------------
-    // 1) Read input
-    // ------------------------------------------------------------
-    std::ifstream inFile(inputPath);
-    if (!inFile) {
-        std::cerr << "Konnte Eingabedatei nicht öffnen: " << inputPath << "\n";
+    BatchOptions opts;
+    ServeOptions sopts;
+    WatchOptions wopts;
+    CompilerOptions copts;
+    MatchOptions match;
+    std::vector<std::string> positional;
+    std::string recoverPath; // --recover: diagnostics report, empty = off
+    bool stats = false;
+    size_t jobs = serveMode || gradeMode ? 0 : 1;
+    try {
+        for (int i = singleMode ? 1 : 2; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (!watchMode && readJobsFlag(argc, argv, i, jobs)) continue;
+            if (readLexerFlag(arg, copts)) continue;
+            if (readFrontendFlag(arg, copts)) continue;
+            if (readFormatFlag(arg, copts)) continue;
+            if (readSortingFlag(arg, copts)) continue;
+            if (!serveMode && !gradeMode && arg == "--cache" && i + 1 < argc) copts.cacheDir = argv[++i];
+            else if (serveMode && arg == "--socket" && i + 1 < argc) sopts.socketPath = argv[++i];
+            else if (serveMode && arg == "--cache-mb" && i + 1 < argc) sopts.cacheBytes = readMegabytes(argv[++i]);
+            else if ((batchMode || watchMode) && arg == "--out" && i + 1 < argc) opts.outDir = argv[++i];
+            else if (watchMode && arg == "--debounce" && i + 1 < argc) wopts.debounceMillis = readMillis(argv[++i]);
+            else if (gradeMode && arg == "--fold") match.fold = true;
+            else if (gradeMode && arg == "--max-edits" && i + 1 < argc) match.maxEdits = readEdits(argv[++i]);
+            else if (singleMode && arg == "--dump-tokens" && i + 1 < argc) copts.tokenDumpPath = argv[++i];
+            else if (singleMode && arg == "--stats") stats = true;
+            else if (singleMode && arg == "--recover" && i + 1 < argc) recoverPath = argv[++i];
+            else positional.push_back(arg);
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
         return 1;
     }
 
-    std::ostringstream buffer;
-    buffer << inFile.rdbuf();
-    std::string input = buffer.str();
+    if (batchMode) {
+        opts.inputs = positional;
+        opts.jobs = jobs;
+        opts.compiler = copts;
+        if (opts.outDir.empty() || opts.inputs.empty()) return usage(argv[0]);
+        return runBatch(opts);
+    }
 
-    if (input.empty()) {
-        std::cerr << "Eingabedatei ist leer: " << inputPath << "\n";
-        return 1;
+    if (serveMode) {
+        if (!positional.empty()) return usage(argv[0]);
+        sopts.jobs = jobs;
+        sopts.compiler = copts;
+        return runServe(sopts);
     }
 
-    // ------------------------------------------------------------
-    // 2) ANTLR parse
-    // ------------------------------------------------------------
-    ANTLRInputStream inputStream(input);
-    AufgabenerstellungsgrammatikLexer lexer(&inputStream);
-    CommonTokenStream tokens(&lexer);
-    
-    // DEBUG: lexer output
-    dumpTokens(tokens);
-
-    AufgabenerstellungsgrammatikParser parser(&tokens);
-
-    auto* progCtx = parser.prog();
-    if (parser.getNumberOfSyntaxErrors() > 0) {
-        std::cerr << "Syntaxfehler in Datei: " << inputPath << "\n";
-        return 1;
+    if (watchMode) {
+        if (opts.outDir.empty() || positional.size() != 1) return usage(argv[0]);
+        wopts.dir = positional[0];
+        wopts.outDir = opts.outDir;
+        wopts.compiler = copts;
+        return runWatch(wopts);
     }
 
-    // ------------------------------------------------------------
-    // 3) ParseTree -> IR
-    // ------------------------------------------------------------
-    IRBuilder builder(input, &tokens);
-    std::any progAny = builder.visitProg(progCtx);
-    ProgramIR progIR = std::any_cast<ProgramIR>(progAny);
-
-    // ------------------------------------------------------------
-    // 4) IR -> Domain (typed)
-    // ------------------------------------------------------------
-    ProgramD progD;
-    try {
-        progD = convertProgram(progIR);
-    } catch (const std::exception& ex) {
-        std::cerr << "Fehler beim Konvertieren IR -> Domain: " << ex.what() << "\n";
-        return 1;
+    if (gradeMode) {
+        if (positional.size() != 3) return usage(argv[0]);
+        GradeOptions gopts;
+        gopts.programPath = positional[0];
+        gopts.responsesPath = positional[1];
+        gopts.outputPath = positional[2];
+        gopts.jobs = jobs;
+        gopts.compiler = copts;
+        gopts.match = match;
+        return runGrade(gopts);
     }
 
-    // ------------------------------------------------------------
-    // 5) Domain -> JSON (SLIM, no empty fields)
-    // ------------------------------------------------------------
-    try {
-        writeDomainToFile(progD, outputPath);
-    } catch (const std::exception& ex) {
-        std::cerr << "Fehler beim Schreiben der Domain-JSON: " << ex.what() << "\n";
+    if (positional.size() != 2) return usage(argv[0]);
+
+    const std::string inputPath  = positional[0];
+    const std::string outputPath = positional[1];
+
+    // Parallel path: split at task boundaries, parse tasks concurrently
+    FileResult res;
+    if (!recoverPath.empty()) {
+        if (!copts.tokenDumpPath.empty()) {
+            std::cerr << "--dump-tokens wird mit --recover nicht unterstützt.\n";
+            return 1;
+        }
+        res = compileFileRecovering(inputPath, outputPath, recoverPath, jobs, copts);
+    } else if (jobs != 1) {
+        if (!copts.tokenDumpPath.empty()) {
+            std::cerr << "--dump-tokens wird mit -j nicht unterstützt.\n";
+            return 1;
+        }
+        res = compileFileSplit(inputPath, outputPath, jobs, copts);
+    } else {
+        Compiler compiler(copts);
+        res = compiler.compileFile(inputPath, outputPath);
+    }
+
+    for (const auto& d : res.diagnostics) std::cerr << d << "\n";
+    if (stats) {
+        std::cerr << "parse: native=" << res.parse.nativeParses
+                  << ", sll=" << res.parse.sllParses
+                  << ", ll_fallback=" << res.parse.llFallbacks
+                  << ", cached=" << res.parse.cachedTasks << "\n";
+    }
+    if (!res.ok) {
+        std::cerr << res.error << "\n";
         return 1;
     }
 
-    std::cerr << "Domain JSON geschrieben: " << outputPath << "\n";
+    std::cerr << (copts.format == OutputFormat::Bin ? "Domain-Binärdatei geschrieben: "
+                                                    : "Domain JSON geschrieben: ")
+              << outputPath << "\n";
     return 0;
 }
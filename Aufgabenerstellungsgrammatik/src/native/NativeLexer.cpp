@@ -0,0 +1,237 @@
+// ============================================================================
+// File: src/native/NativeLexer.cpp
+// ============================================================================
+#include "native/NativeLexer.h"
+
+#include "native/UnicodeLetters.h"
+
+namespace {
+
+// Decodes one UTF-8 sequence at s[i]; invalid bytes decode as themselves (length 1).
+uint32_t decodeUtf8(std::string_view s, size_t i, size_t& len) {
+    const auto b0 = static_cast<unsigned char>(s[i]);
+    if (b0 < 0x80) {
+        len = 1;
+        return b0;
+    }
+
+    size_t need = 0;
+    uint32_t cp = 0;
+    if ((b0 & 0xE0) == 0xC0) { need = 1; cp = b0 & 0x1F; }
+    else if ((b0 & 0xF0) == 0xE0) { need = 2; cp = b0 & 0x0F; }
+    else if ((b0 & 0xF8) == 0xF0) { need = 3; cp = b0 & 0x07; }
+    else { len = 1; return b0; }
+
+    if (i + need >= s.size()) {
+        len = 1;
+        return b0;
+    }
+    for (size_t k = 1; k <= need; ++k) {
+        const auto b = static_cast<unsigned char>(s[i + k]);
+        if ((b & 0xC0) != 0x80) {
+            len = 1;
+            return b0;
+        }
+        cp = (cp << 6) | (b & 0x3F);
+    }
+    len = need + 1;
+    return cp;
+}
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+NativeTokenType keywordType(std::string_view w) {
+    switch (w.size()) {
+    case 3:  if (w == "RoF") return NativeTokenType::RightOrFalse; break;
+    case 7:  if (w == "Auswahl") return NativeTokenType::ChoiceText; break;
+    case 9:
+        if (w == "Umordnung") return NativeTokenType::Sorting;
+        if (w == "Zuordnung") return NativeTokenType::Matching;
+        break;
+    case 10: if (w == "Markierung") return NativeTokenType::Marking; break;
+    case 11: if (w == "L\xC3\xBC" "ckentext") return NativeTokenType::ClozeText; break; // "Lückentext"
+    case 13: if (w == "Textkorrektur") return NativeTokenType::CorrectionText; break;
+    default: break;
+    }
+    return NativeTokenType::Letters;
+}
+
+// ANTLR's Lexer::getErrorDisplay
+std::string errorDisplay(std::string_view s) {
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        switch (c) {
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        case '\r': out += "\\r"; break;
+        default:   out += c;     break;
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+NativeLexer::NativeLexer(std::string_view source, size_t firstLine)
+    : src(source), curLine(static_cast<uint32_t>(firstLine)) {}
+
+void NativeLexer::advanceCodePoint() {
+    if (src[pos] == '\n') {
+        ++curLine;
+        curColumn = 0;
+        ++pos;
+        return;
+    }
+    size_t len = 1;
+    decodeUtf8(src, pos, len);
+    pos += len;
+    ++curColumn;
+}
+
+NativeToken NativeLexer::make(NativeTokenType type, size_t start, uint32_t line, uint32_t column) const {
+    NativeToken t;
+    t.type = type;
+    t.text = src.substr(start, pos - start);
+    t.offset = start;
+    t.line = line;
+    t.column = column;
+    return t;
+}
+
+void NativeLexer::reportError(size_t start, uint32_t line, uint32_t column) {
+    NativeLexError e;
+    e.line = line;
+    e.column = column;
+    e.message = "token recognition error at: '" + errorDisplay(src.substr(start, pos - start)) + "'";
+    errs.push_back(std::move(e));
+}
+
+NativeToken NativeLexer::next() {
+    using T = NativeTokenType;
+
+    for (;;) {
+        const size_t n = src.size();
+        if (pos >= n) {
+            NativeToken eof;
+            eof.type = T::Eof;
+            eof.offset = n;
+            eof.line = curLine;
+            eof.column = curColumn;
+            return eof;
+        }
+
+        const char c = src[pos];
+
+        // WS: [ \t]+ -> skip
+        if (c == ' ' || c == '\t') {
+            ++pos;
+            ++curColumn;
+            continue;
+        }
+
+        const size_t start = pos;
+        const uint32_t line = curLine;
+        const uint32_t column = curColumn;
+
+        auto single = [&](T type) {
+            ++pos;
+            ++curColumn;
+            return make(type, start, line, column);
+        };
+
+        switch (c) {
+        case '\n':
+            ++pos;
+            ++curLine;
+            curColumn = 0;
+            return make(T::Newline, start, line, column);
+        case '\r':
+            if (pos + 1 < n && src[pos + 1] == '\n') {
+                pos += 2;
+                ++curLine;
+                curColumn = 0;
+                return make(T::Newline, start, line, column);
+            }
+            // NEWLINE: '\r'? '\n' fails on the next char; ANTLR reports "\r<next>"
+            // and its recovery consumes that next char as well.
+            ++pos;
+            ++curColumn;
+            if (pos < n) advanceCodePoint();
+            reportError(start, line, column);
+            continue;
+        case '(': return single(T::LParen);
+        case ')': return single(T::RParen);
+        case ':': return single(T::Colon);
+        case ';': return single(T::Semi);
+        case '/': return single(T::Slash);
+        case '[': return single(T::LBracket);
+        case ',': return single(T::Comma);
+        case ']': return single(T::RBracket);
+        case '.':
+        case '?':
+        case '!': return single(T::Punctuation);
+        case '-': {
+            const std::string_view rest = src.substr(pos);
+            if (rest.size() >= 2 && rest[1] == '>') {
+                pos += 2;
+                curColumn += 2;
+                return make(T::Arrow, start, line, column);
+            }
+            if (rest.substr(0, 8) == "-Richtig") {
+                pos += 8;
+                curColumn += 8;
+                return make(T::AnswerTrue, start, line, column);
+            }
+            if (rest.substr(0, 7) == "-Falsch") {
+                pos += 7;
+                curColumn += 7;
+                return make(T::AnswerFalse, start, line, column);
+            }
+            return single(T::Dash);
+        }
+        default:
+            break;
+        }
+
+        if (isDigit(c)) {
+            while (pos < n && isDigit(src[pos])) {
+                ++pos;
+                ++curColumn;
+            }
+            return make(T::Number, start, line, column);
+        }
+
+        size_t len = 1;
+        uint32_t cp = decodeUtf8(src, pos, len);
+        if (isUnicodeLetter(cp)) {
+            do {
+                pos += len;
+                ++curColumn;
+                if (pos >= n) break;
+                cp = decodeUtf8(src, pos, len);
+            } while (isUnicodeLetter(cp));
+            NativeToken t = make(T::Letters, start, line, column);
+            t.type = keywordType(t.text);
+            return t;
+        }
+
+        // no rule matches: report the code point and skip it
+        pos += len;
+        ++curColumn;
+        reportError(start, line, column);
+    }
+}
+
+std::vector<NativeToken> lexAll(std::string_view source, std::vector<NativeLexError>* errors,
+                                size_t firstLine) {
+    NativeLexer lexer(source, firstLine);
+    std::vector<NativeToken> out;
+    out.reserve(source.size() / 4 + 1);
+    for (;;) {
+        out.push_back(lexer.next());
+        if (out.back().type == NativeTokenType::Eof) break;
+    }
+    if (errors) *errors = lexer.errors();
+    return out;
+}
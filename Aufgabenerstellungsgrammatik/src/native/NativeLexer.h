@@ -0,0 +1,87 @@
+// ============================================================================
+// File: src/native/NativeLexer.h
+// Hand-written UTF-8 lexer for Aufgabenerstellungsgrammatik.g4 (zero-copy)
+// ============================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Same numbering as the generated AufgabenerstellungsgrammatikLexer
+// (static_asserts in NativeTokenSource.cpp keep both in sync).
+enum class NativeTokenType : int {
+    Eof            = -1,
+    LParen         = 1,  // '('  T__0
+    RParen         = 2,  // ')'  T__1
+    Colon          = 3,  // ':'  T__2
+    Semi           = 4,  // ';'  T__3
+    Dash           = 5,  // '-'  T__4
+    Slash          = 6,  // '/'  T__5
+    LBracket       = 7,  // '['  T__6
+    Comma          = 8,  // ','  T__7
+    RBracket       = 9,  // ']'  T__8
+    RightOrFalse   = 10,
+    Sorting        = 11,
+    Matching       = 12,
+    Marking        = 13,
+    ClozeText      = 14,
+    CorrectionText = 15,
+    ChoiceText     = 16,
+    AnswerTrue     = 17,
+    AnswerFalse    = 18,
+    Punctuation    = 19,
+    Letters        = 20,
+    Number         = 21,
+    Connection     = 22, // never produced: ',' ':' '-' ';' are literal tokens first
+    Arrow          = 23,
+    Ws             = 24, // skipped
+    Newline        = 25
+};
+
+struct NativeToken {
+    NativeTokenType type = NativeTokenType::Eof;
+    std::string_view text; // view into the source buffer
+    size_t offset = 0;     // byte offset of text[0]
+    uint32_t line = 1;
+    uint32_t column = 0;   // in code points, like ANTLR's charPositionInLine
+};
+
+struct NativeLexError {
+    uint32_t line = 1;
+    uint32_t column = 0;
+    std::string message; // "token recognition error at: '...'"
+};
+
+// Longest match with rule-order tie break, exactly like the generated lexer:
+// keywords only when the whole letter run matches, "-Richtig"/"-Falsch"/"->"
+// before '-', WS skipped, unknown characters reported and skipped.
+class NativeLexer {
+public:
+    explicit NativeLexer(std::string_view source, size_t firstLine = 1);
+
+    NativeToken next();
+
+    uint32_t line() const { return curLine; }
+    uint32_t column() const { return curColumn; }
+
+    // Appended while lexing; consumers forward new entries after each next().
+    const std::vector<NativeLexError>& errors() const { return errs; }
+
+private:
+    void advanceCodePoint();
+    void reportError(size_t start, uint32_t line, uint32_t column);
+    NativeToken make(NativeTokenType type, size_t start, uint32_t line, uint32_t column) const;
+
+    std::string_view src;
+    size_t pos = 0;
+    uint32_t curLine = 1;
+    uint32_t curColumn = 0;
+    std::vector<NativeLexError> errs;
+};
+
+// Convenience: every token up to and including Eof.
+std::vector<NativeToken> lexAll(std::string_view source, std::vector<NativeLexError>* errors = nullptr,
+                                size_t firstLine = 1);
@@ -0,0 +1,525 @@
+// ============================================================================
+// File: src/native/NativeParser.cpp
+// ============================================================================
+#include "native/NativeParser.h"
+
+#include <climits>
+#include <utility>
+
+namespace {
+
+// thrown on the first token the grammar does not allow; caught at the entry points
+struct ParseFailure {};
+
+bool isWordish(NativeTokenType t) {
+    return t == NativeTokenType::Letters || t == NativeTokenType::Number;
+}
+
+// IRBuilder::textJoin spacing: only these pairs get a blank, everything else is glued
+bool spaceBetween(NativeTokenType prev, NativeTokenType cur) {
+    using T = NativeTokenType;
+    if (prev == T::Number && cur == T::Number) return false; // "1" "6" -> "16"
+    if (isWordish(prev) && isWordish(cur)) return true;
+    if (isWordish(prev) && cur == T::LParen) return true;
+    if (prev == T::RParen && isWordish(cur)) return true;
+    return false;
+}
+
+} // namespace
+
+NativeParser::NativeParser(std::string_view source, Arena& irArena, size_t firstLine)
+    : arena(irArena) {
+    std::vector<NativeLexError> lexErrors;
+    toks = lexAll(source, &lexErrors, firstLine);
+    lexOk = lexErrors.empty();
+}
+
+// -------------------------
+// Token helpers
+// -------------------------
+const NativeToken& NativeParser::peek(size_t k) const {
+    const size_t i = pos + k;
+    return i < toks.size() ? toks[i] : toks.back(); // toks always ends with Eof
+}
+
+void NativeParser::fail(const char* what) const {
+    const NativeToken& t = peek();
+    auto& e = const_cast<std::string&>(err);
+    e = "line " + std::to_string(t.line) + ":" + std::to_string(t.column) + " expected " + what +
+        " at '" + std::string(t.text) + "'";
+    throw ParseFailure{};
+}
+
+const NativeToken& NativeParser::expect(T type, const char* what) {
+    if (!at(type)) fail(what);
+    return toks[pos++];
+}
+
+int NativeParser::parseIntStrict(std::string_view s) {
+    // std::stoi semantics for [-]digits, overflow is an error (IRBuilder throws there)
+    bool neg = false;
+    size_t i = 0;
+    if (!s.empty() && s[0] == '-') {
+        neg = true;
+        i = 1;
+    }
+    if (i >= s.size()) throw ParseFailure{};
+
+    long long v = 0;
+    for (; i < s.size(); ++i) {
+        if (s[i] < '0' || s[i] > '9') throw ParseFailure{};
+        v = v * 10 + (s[i] - '0');
+        if (v > static_cast<long long>(INT_MAX) + 1) throw ParseFailure{};
+    }
+    if (neg) v = -v;
+    if (v > INT_MAX || v < INT_MIN) throw ParseFailure{};
+    return static_cast<int>(v);
+}
+
+IRString NativeParser::text(const Span& s) {
+    if (s.last == s.first + 1) return arena.intern(toks[s.first].text); // single word: no join
+
+    scratch.clear();
+    const NativeToken* prev = nullptr;
+    for (size_t i = s.first; i < s.last; ++i) {
+        const NativeToken& t = toks[i];
+        if (t.type == T::Newline) { // endless_words never spans NEWLINE; mirror textJoin anyway
+            prev = nullptr;
+            continue;
+        }
+        if (prev && spaceBetween(prev->type, t.type)) scratch += ' ';
+        scratch.append(t.text);
+        prev = &t;
+    }
+    return arena.intern(scratch);
+}
+
+// -------------------------
+// Entry points
+// -------------------------
+bool NativeParser::parseProgram(ProgramIR& out) {
+    if (!lexOk) return false;
+    pos = 0;
+    ArenaScope scope(arena);
+    try {
+        // prog: tasks NEWLINE? EOF;  tasks: (task_definition NEWLINE)* task_definition;
+        for (;;) {
+            out.tasks.push_back(taskDefinition());
+            if (at(T::Newline)) {
+                ++pos;
+                if (at(T::Eof)) break;
+                continue;
+            }
+            if (at(T::Eof)) break;
+            fail("NEWLINE or EOF");
+        }
+    } catch (const ParseFailure&) {
+        return false;
+    }
+    return true;
+}
+
+bool NativeParser::parseTaskUnit(TaskIR& out) {
+    if (!lexOk) return false;
+    pos = 0;
+    ArenaScope scope(arena);
+    try {
+        out = taskDefinition();
+        expect(T::Eof, "EOF");
+    } catch (const ParseFailure&) {
+        return false;
+    }
+    return true;
+}
+
+// -------------------------
+// Basic rules
+// -------------------------
+
+// endless_words: (word)+ (CONNECTION? (word)+)*;
+NativeParser::Span NativeParser::endlessWords() {
+    if (!atWord()) fail("word");
+    Span s;
+    s.first = pos;
+    while (atWord()) ++pos;
+    while (at(T::Connection) && atWord(1)) {
+        ++pos;
+        while (atWord()) ++pos;
+    }
+    s.last = pos;
+    return s;
+}
+
+// sentence: endless_words PUNCTUATION;
+SentenceIR NativeParser::sentence() {
+    SentenceIR s;
+    s.text = text(endlessWords());
+    s.punctuation = expect(T::Punctuation, "PUNCTUATION").text[0];
+    return s;
+}
+
+// word: (LETTERS | NUMBER);
+IRString NativeParser::word() {
+    if (!atWord()) fail("word");
+    return arena.intern(toks[pos++].text);
+}
+
+// positive_task_point: NUMBER;
+int NativeParser::positivePoint() {
+    return parseIntStrict(expect(T::Number, "NUMBER").text);
+}
+
+// negative_task_point: ('-' NUMBER);  (getText() of the context is "-<digits>")
+int NativeParser::negativePoint() {
+    expect(T::Dash, "'-'");
+    const std::string_view digits = expect(T::Number, "NUMBER").text;
+    return parseIntStrict("-" + std::string(digits));
+}
+
+// ('(' positive_task_point ')')?
+void NativeParser::optionalTaskPoints(TaskPointsIR& points) {
+    if (!at(T::LParen)) {
+        points.pointsIfAllCorrect.reset();
+        points.scoringMode = ScoringModeIR::PartialPerCorrect;
+        return;
+    }
+    ++pos;
+    points.pointsIfAllCorrect = positivePoint();
+    points.scoringMode = ScoringModeIR::AllOrNothing;
+    expect(T::RParen, "')'");
+}
+
+// -------------------------
+// task_definition: endless_words task;
+// -------------------------
+TaskIR NativeParser::taskDefinition() {
+    TaskIR task;
+    task.header = text(endlessWords());
+
+    expect(T::LParen, "'('");
+    const T kind = peek().type;
+    switch (kind) {
+    case T::RightOrFalse:
+    case T::Sorting:
+    case T::Matching:
+    case T::Marking:
+    case T::ClozeText:
+    case T::CorrectionText:
+    case T::ChoiceText:
+        ++pos;
+        break;
+    default:
+        fail("task type");
+    }
+    expect(T::RParen, "')'");
+    expect(T::Colon, "':'");
+    if (at(T::Newline)) ++pos;
+
+    switch (kind) {
+    case T::RightOrFalse:   task.kind = TaskKind::RoF;        rofTask(task); break;
+    case T::Sorting:        task.kind = TaskKind::Sorting;    sortingTask(task); break;
+    case T::Matching:       task.kind = TaskKind::Matching;   matchingTask(task); break;
+    case T::Marking:        task.kind = TaskKind::Marking;    markingTask(task); break;
+    case T::ClozeText:      task.kind = TaskKind::Cloze;      clozeTask(task); break;
+    case T::CorrectionText: task.kind = TaskKind::Correction; correctionTask(task); break;
+    default:                task.kind = TaskKind::Choice;     choiceTask(task); break;
+    }
+
+    expect(T::Semi, "';'");
+    return task;
+}
+
+// -------------------------
+// RoF: true_false_task (NEWLINE true_false_task)*
+// -------------------------
+void NativeParser::rofTask(TaskIR& task) {
+    for (;;) {
+        TrueFalseTaskIR line;
+        line.question = sentence();
+
+        // true_false_answer: ANSWER_TRUE | ANSWER_FALSE ARROW reason;
+        if (at(T::AnswerTrue)) {
+            ++pos;
+            line.answer.isTrue = true;
+        } else {
+            expect(T::AnswerFalse, "-Richtig or -Falsch");
+            expect(T::Arrow, "'->'");
+            line.answer.isTrue = false;
+            // reason: sentence | endless_words (the latter always reports an error)
+            line.answer.reason = sentence();
+        }
+        task.rof.push_back(std::move(line));
+
+        if (!at(T::Newline)) break;
+        ++pos;
+    }
+}
+
+// -------------------------
+// Sorting: sorting_task (NEWLINE sorting_task)*
+// -------------------------
+void NativeParser::sortingTask(TaskIR& task) {
+    for (;;) {
+        // sorting_task: question_or_statement ('(' positive_task_point ')')? item+;
+        SortingLineIR line;
+        line.question = sentence();
+        optionalTaskPoints(line.points);
+
+        do {
+            expect(T::Dash, "'-'");
+            line.items.push_back(word());
+        } while (at(T::Dash));
+
+        task.sorting.push_back(std::move(line));
+
+        if (!at(T::Newline)) break;
+        ++pos;
+    }
+}
+
+// -------------------------
+// Matching: matching_task (NEWLINE matching_task)*
+// -------------------------
+void NativeParser::matchingTask(TaskIR& task) {
+    for (;;) {
+        MatchingLineIR line;
+
+        // endless_words '(' word ')' endless_words '(' word ')' PUNCTUATION
+        line.question.prefix = text(endlessWords());
+        expect(T::LParen, "'('");
+        line.question.slotA = word();
+        expect(T::RParen, "')'");
+        line.question.middle = text(endlessWords());
+        expect(T::LParen, "'('");
+        line.question.slotB = word();
+        expect(T::RParen, "')'");
+        line.question.punctuation = expect(T::Punctuation, "PUNCTUATION").text[0];
+
+        optionalTaskPoints(line.points);
+
+        // matching_item: '-' word '/' word;
+        do {
+            expect(T::Dash, "'-'");
+            MatchingItemIR p;
+            p.left = word();
+            expect(T::Slash, "'/'");
+            p.right = word();
+            line.pairs.push_back(std::move(p));
+        } while (at(T::Dash));
+
+        task.matching.push_back(std::move(line));
+
+        if (!at(T::Newline)) break;
+        ++pos;
+    }
+}
+
+// -------------------------
+// Marking / Cloze / Correction share the text shape:
+//   <x>_text:     ((sentence | <x>_sentence)+ NEWLINE?)*;
+//   <x>_sentence: (endless_words? (<x>_word endless_words?)+ PUNCTUATION);
+// IRBuilder emits all <x>_sentences first and the plain sentences after them,
+// and always puts the first endless_words of a sentence before the first inline
+// element. Both quirks are kept so the JSON stays identical.
+// -------------------------
+template <class SentenceT, class ParseInline, class SetInline>
+void NativeParser::inlineText(IRVector<SentenceT>& out, ParseInline parseInline, SetInline setInline) {
+    using PartT = typename decltype(SentenceT::parts)::value_type;
+    using InlineT = decltype(parseInline());
+
+    std::vector<SentenceT> plain;
+    bool newlineAllowed = false;
+
+    while (!at(T::Semi)) {
+        if (at(T::Newline)) {
+            if (!newlineAllowed) fail("sentence");
+            ++pos;
+            newlineAllowed = false;
+            continue;
+        }
+
+        std::vector<Span> words;
+        std::vector<InlineT> inlines;
+        for (;;) {
+            if (atWord()) words.push_back(endlessWords());
+            else if (at(T::LParen)) inlines.push_back(parseInline());
+            else break;
+        }
+        const char punct = expect(T::Punctuation, "PUNCTUATION").text[0];
+
+        SentenceT s;
+        s.punctuation = punct;
+
+        if (inlines.empty()) {
+            if (words.size() != 1) fail("sentence");
+            PartT p;
+            p.text = text(words[0]);
+            s.parts.push_back(std::move(p));
+            plain.push_back(std::move(s));
+        } else {
+            size_t ewIdx = 0;
+            if (!words.empty()) {
+                PartT p;
+                p.text = text(words[ewIdx++]);
+                s.parts.push_back(std::move(p));
+            }
+            for (auto& in : inlines) {
+                PartT pi;
+                setInline(pi, std::move(in));
+                s.parts.push_back(std::move(pi));
+
+                if (ewIdx < words.size()) {
+                    PartT pt;
+                    pt.text = text(words[ewIdx++]);
+                    s.parts.push_back(std::move(pt));
+                }
+            }
+            out.push_back(std::move(s));
+        }
+        newlineAllowed = true;
+    }
+
+    for (auto& s : plain) out.push_back(std::move(s));
+}
+
+// marking_task: question_or_statement NEWLINE? marking_text;
+void NativeParser::markingTask(TaskIR& task) {
+
+    MarkingTaskIR out;
+    out.question = sentence();
+    if (at(T::Newline)) ++pos;
+
+    inlineText(out.sentences,
+        [this] {
+            // marked_word: '(' endless_words ')' marked_word_point;
+            MarkedSpanIR mark;
+            expect(T::LParen, "'('");
+            mark.markedText = text(endlessWords());
+            expect(T::RParen, "')'");
+
+            // marked_word_point: '[' endless_words ',' positive_task_point ']' | '[' positive_task_point ']';
+            expect(T::LBracket, "'['");
+            if (at(T::Number) && at(T::RBracket, 1)) {
+                mark.correction.reset();
+            } else {
+                mark.correction = text(endlessWords());
+                expect(T::Comma, "','");
+            }
+            mark.points = positivePoint();
+            expect(T::RBracket, "']'");
+            return mark;
+        },
+        [](MarkingPartIR& p, MarkedSpanIR&& m) { p.mark = std::move(m); });
+
+    task.marking = std::move(out);
+}
+
+// cloze_task: question_or_statement NEWLINE? cloze_text;
+void NativeParser::clozeTask(TaskIR& task) {
+
+    ClozeTaskIR out;
+    out.question = sentence();
+    if (at(T::Newline)) ++pos;
+
+    inlineText(out.sentences,
+        [this] {
+            // cloze_word: '(' word ',' positive_task_point ')';
+            ClozeBlankIR b;
+            expect(T::LParen, "'('");
+            b.solution = word();
+            expect(T::Comma, "','");
+            b.points = positivePoint();
+            expect(T::RParen, "')'");
+            return b;
+        },
+        [](ClozePartIR& p, ClozeBlankIR&& b) { p.blank = std::move(b); });
+
+    task.cloze = std::move(out);
+}
+
+// correction_task: question_or_statement NEWLINE? correction_text;
+void NativeParser::correctionTask(TaskIR& task) {
+
+    CorrectionTaskIR out;
+    out.question = sentence();
+    if (at(T::Newline)) ++pos;
+
+    inlineText(out.sentences,
+        [this] {
+            // correction_word: '(' word ')' ('[' word ',' positive_task_point ']');
+            CorrectionSpanIR c;
+            expect(T::LParen, "'('");
+            c.wrong = word();
+            expect(T::RParen, "')'");
+            expect(T::LBracket, "'['");
+            c.correct = word();
+            expect(T::Comma, "','");
+            c.points = positivePoint();
+            expect(T::RBracket, "']'");
+            return c;
+        },
+        [](CorrectionPartIR& p, CorrectionSpanIR&& c) { p.corr = std::move(c); });
+
+    task.correction = std::move(out);
+}
+
+// -------------------------
+// Choice: choice_task (NEWLINE choice_task)*
+// choice_task:   question_or_statement correct_choice+ false_choices;
+// correct_choice: '-' endless_words '(' positive_task_point ')';
+// false_choices: ('-' endless_words '(' negative_task_point ')')+ | ('-' endless_words)+;
+// -------------------------
+void NativeParser::choiceTask(TaskIR& task) {
+
+    enum class Opt { Correct, FalseWithPoints, FalsePlain, None };
+
+    // classify the option starting at the current '-' without consuming it
+    auto classify = [this]() {
+        if (!at(T::Dash) || !atWord(1)) return Opt::None;
+        size_t k = 1;
+        while (atWord(k) || (at(T::Connection, k) && atWord(k + 1))) ++k;
+        if (at(T::LParen, k) && at(T::Number, k + 1)) return Opt::Correct;
+        if (at(T::LParen, k) && at(T::Dash, k + 1)) return Opt::FalseWithPoints;
+        return Opt::FalsePlain;
+    };
+
+    for (;;) {
+        ChoiceLineIR line;
+        line.question = sentence();
+
+        if (classify() != Opt::Correct) fail("correct choice");
+        while (classify() == Opt::Correct) {
+            ++pos; // '-'
+            ChoiceOptionIR opt;
+            opt.isCorrect = true;
+            opt.text = text(endlessWords());
+            expect(T::LParen, "'('");
+            opt.points = positivePoint();
+            expect(T::RParen, "')'");
+            line.options.push_back(std::move(opt));
+        }
+
+        const Opt falseKind = classify();
+        if (falseKind != Opt::FalseWithPoints && falseKind != Opt::FalsePlain) fail("false choice");
+        while (at(T::Dash)) {
+            if (classify() != falseKind) fail("false choice of the same form");
+            ++pos; // '-'
+            ChoiceOptionIR opt;
+            opt.isCorrect = false;
+            opt.text = text(endlessWords());
+            if (falseKind == Opt::FalseWithPoints) {
+                expect(T::LParen, "'('");
+                opt.points = negativePoint();
+                expect(T::RParen, "')'");
+            } else {
+                opt.points = 0;
+            }
+            line.options.push_back(std::move(opt));
+        }
+
+        task.choice.push_back(std::move(line));
+
+        if (!at(T::Newline)) break;
+        ++pos;
+    }
+}
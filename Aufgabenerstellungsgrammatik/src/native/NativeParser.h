@@ -0,0 +1,79 @@
+// ============================================================================
+// File: src/native/NativeParser.h
+// Recursive-descent front end: tokens -> ProgramIR (no parse tree, no visitor)
+// ============================================================================
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ir/IR.h"
+#include "native/NativeLexer.h"
+
+// Predictive parser for Aufgabenerstellungsgrammatik.g4 that builds the same IR
+// as IRBuilder (including its part ordering and spacing rules).
+//
+// It only accepts input the grammar accepts; on anything else it stops and
+// returns false WITHOUT diagnostics - callers re-run the ANTLR front end,
+// which stays the reference and produces the error messages.
+class NativeParser {
+public:
+    // `source` must outlive the parser; `firstLine` as in Compiler::compileTask.
+    // All IR strings are interned into `arena`, which must outlive the IR.
+    NativeParser(std::string_view source, Arena& arena, size_t firstLine = 1);
+
+    // prog: tasks NEWLINE? EOF
+    bool parseProgram(ProgramIR& out);
+
+    // task_unit: task_definition EOF
+    bool parseTaskUnit(TaskIR& out);
+
+    // "line L:C <reason>" of the first mismatch (debug aid, not an ANTLR message)
+    const std::string& error() const { return err; }
+
+private:
+    using T = NativeTokenType;
+
+    struct Span {
+        size_t first = 0; // token index range [first, last)
+        size_t last = 0;
+    };
+
+    const NativeToken& peek(size_t k = 0) const;
+    bool at(T type, size_t k = 0) const { return peek(k).type == type; }
+    bool atWord(size_t k = 0) const { return at(T::Letters, k) || at(T::Number, k); }
+    const NativeToken& expect(T type, const char* what);
+    [[noreturn]] void fail(const char* what) const;
+
+    // ---- grammar rules ----
+    TaskIR taskDefinition();
+    Span endlessWords();
+    SentenceIR sentence();
+    IRString word();
+    int positivePoint();
+    int negativePoint();
+    void optionalTaskPoints(TaskPointsIR& points);
+
+    void rofTask(TaskIR& task);
+    void sortingTask(TaskIR& task);
+    void matchingTask(TaskIR& task);
+    void markingTask(TaskIR& task);
+    void clozeTask(TaskIR& task);
+    void correctionTask(TaskIR& task);
+    void choiceTask(TaskIR& task);
+
+    template <class SentenceT, class ParseInline, class SetInline>
+    void inlineText(IRVector<SentenceT>& out, ParseInline parseInline, SetInline setInline);
+
+    // ---- IRBuilder-compatible text reconstruction ----
+    IRString text(const Span& s);
+    static int parseIntStrict(std::string_view s);
+
+    std::vector<NativeToken> toks;
+    Arena& arena;
+    std::string scratch; // joined multi-token text before interning
+    bool lexOk = true;
+    size_t pos = 0;
+    std::string err;
+};
@@ -0,0 +1,99 @@
+// ============================================================================
+// File: src/native/NativeTokenSource.cpp
+// ============================================================================
+#include "native/NativeTokenSource.h"
+
+#include "AufgabenerstellungsgrammatikLexer.h"
+
+using Lexer = AufgabenerstellungsgrammatikLexer;
+using T = NativeTokenType;
+
+// keep the hand-written token ids in sync with the grammar
+static_assert(static_cast<int>(T::LParen) == Lexer::T__0, "'(' id");
+static_assert(static_cast<int>(T::RParen) == Lexer::T__1, "')' id");
+static_assert(static_cast<int>(T::Colon) == Lexer::T__2, "':' id");
+static_assert(static_cast<int>(T::Semi) == Lexer::T__3, "';' id");
+static_assert(static_cast<int>(T::Dash) == Lexer::T__4, "'-' id");
+static_assert(static_cast<int>(T::Slash) == Lexer::T__5, "'/' id");
+static_assert(static_cast<int>(T::LBracket) == Lexer::T__6, "'[' id");
+static_assert(static_cast<int>(T::Comma) == Lexer::T__7, "',' id");
+static_assert(static_cast<int>(T::RBracket) == Lexer::T__8, "']' id");
+static_assert(static_cast<int>(T::RightOrFalse) == Lexer::RIGHT_OR_FALSE, "RIGHT_OR_FALSE id");
+static_assert(static_cast<int>(T::Sorting) == Lexer::SORTING, "SORTING id");
+static_assert(static_cast<int>(T::Matching) == Lexer::MATCHING, "MATCHING id");
+static_assert(static_cast<int>(T::Marking) == Lexer::MARKING, "MARKING id");
+static_assert(static_cast<int>(T::ClozeText) == Lexer::CLOZE_TEXT, "CLOZE_TEXT id");
+static_assert(static_cast<int>(T::CorrectionText) == Lexer::CORRECTION_TEXT, "CORRECTION_TEXT id");
+static_assert(static_cast<int>(T::ChoiceText) == Lexer::CHOICE_TEXT, "CHOICE_TEXT id");
+static_assert(static_cast<int>(T::AnswerTrue) == Lexer::ANSWER_TRUE, "ANSWER_TRUE id");
+static_assert(static_cast<int>(T::AnswerFalse) == Lexer::ANSWER_FALSE, "ANSWER_FALSE id");
+static_assert(static_cast<int>(T::Punctuation) == Lexer::PUNCTUATION, "PUNCTUATION id");
+static_assert(static_cast<int>(T::Letters) == Lexer::LETTERS, "LETTERS id");
+static_assert(static_cast<int>(T::Number) == Lexer::NUMBER, "NUMBER id");
+static_assert(static_cast<int>(T::Connection) == Lexer::CONNECTION, "CONNECTION id");
+static_assert(static_cast<int>(T::Arrow) == Lexer::ARROW, "ARROW id");
+static_assert(static_cast<int>(T::Ws) == Lexer::WS, "WS id");
+static_assert(static_cast<int>(T::Newline) == Lexer::NEWLINE, "NEWLINE id");
+
+// -------------------------
+// ViewToken
+// -------------------------
+ViewToken::ViewToken(const NativeToken& t, antlr4::TokenSource* src)
+    : type(t.type == T::Eof ? antlr4::Token::EOF : static_cast<size_t>(t.type)),
+      text(t.text),
+      line(t.line),
+      column(t.column),
+      start(t.offset),
+      stop(t.offset + t.text.size() - 1),
+      source(src) {}
+
+std::string ViewToken::getText() const {
+    if (ownedText) return *ownedText;
+    if (type == antlr4::Token::EOF) return "<EOF>";
+    return std::string(text);
+}
+
+void ViewToken::setText(const std::string& t) {
+    ownedText = std::make_unique<std::string>(t);
+    text = *ownedText;
+}
+
+std::string ViewToken::toString() const {
+    std::string txt = getText();
+    for (char& c : txt) {
+        if (c == '\n') c = ' ';
+    }
+    return "[@" + std::to_string(static_cast<long long>(index)) + "," + std::to_string(start) + ":" +
+           std::to_string(static_cast<long long>(stop)) + "='" + txt + "',<" +
+           std::to_string(static_cast<long long>(type)) + ">," + std::to_string(line) + ":" +
+           std::to_string(column) + "]";
+}
+
+// -------------------------
+// NativeTokenSource
+// -------------------------
+void NativeTokenSource::reset(std::string_view source, const std::string& sourceName, size_t firstLine,
+                              antlr4::ANTLRErrorListener* errors) {
+    lexer = NativeLexer(source, firstLine);
+    name = sourceName;
+    errorListener = errors;
+    reportedErrors = 0;
+}
+
+std::unique_ptr<antlr4::Token> NativeTokenSource::nextToken() {
+    NativeToken t = lexer.next();
+
+    // forward lexer errors in the order the generated lexer would report them
+    const auto& errs = lexer.errors();
+    for (; reportedErrors < errs.size(); ++reportedErrors) {
+        if (!errorListener) continue;
+        const auto& e = errs[reportedErrors];
+        errorListener->syntaxError(nullptr, nullptr, e.line, e.column, e.message, nullptr);
+    }
+
+    return std::make_unique<ViewToken>(t, this);
+}
+
+antlr4::TokenFactory<antlr4::CommonToken>* NativeTokenSource::getTokenFactory() {
+    return antlr4::CommonTokenFactory::DEFAULT.get();
+}
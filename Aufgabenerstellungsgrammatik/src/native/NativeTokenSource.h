@@ -0,0 +1,74 @@
+// ============================================================================
+// File: src/native/NativeTokenSource.h
+// Adapter: NativeLexer -> antlr4::TokenSource (generated parser keeps working)
+// ============================================================================
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "antlr4-runtime.h"
+
+#include "native/NativeLexer.h"
+
+// Token whose text is a view into the source buffer. Start/stop indices are
+// BYTE offsets (the generated lexer reports code point indices).
+class ViewToken : public antlr4::WritableToken {
+public:
+    ViewToken(const NativeToken& t, antlr4::TokenSource* source);
+
+    std::string getText() const override;
+    size_t getType() const override { return type; }
+    size_t getLine() const override { return line; }
+    size_t getCharPositionInLine() const override { return column; }
+    size_t getChannel() const override { return antlr4::Token::DEFAULT_CHANNEL; }
+    size_t getTokenIndex() const override { return index; }
+    size_t getStartIndex() const override { return start; }
+    size_t getStopIndex() const override { return stop; }
+    antlr4::TokenSource* getTokenSource() const override { return source; }
+    antlr4::CharStream* getInputStream() const override { return nullptr; }
+    std::string toString() const override;
+
+    void setText(const std::string& t) override;
+    void setType(size_t ttype) override { type = ttype; }
+    void setLine(size_t l) override { line = l; }
+    void setCharPositionInLine(size_t pos) override { column = pos; }
+    void setChannel(size_t) override {}
+    void setTokenIndex(size_t i) override { index = i; }
+
+    std::string_view view() const { return text; }
+
+private:
+    size_t type;
+    std::string_view text;
+    std::unique_ptr<std::string> ownedText; // only after setText()
+    size_t line;
+    size_t column;
+    size_t start;
+    size_t stop;
+    size_t index = antlr4::INVALID_INDEX;
+    antlr4::TokenSource* source;
+};
+
+class NativeTokenSource : public antlr4::TokenSource {
+public:
+    NativeTokenSource() : lexer(std::string_view()) {}
+
+    // `source` must outlive every token handed out; lexer errors go to `errors`.
+    void reset(std::string_view source, const std::string& sourceName, size_t firstLine,
+               antlr4::ANTLRErrorListener* errors);
+
+    std::unique_ptr<antlr4::Token> nextToken() override;
+    size_t getLine() const override { return lexer.line(); }
+    size_t getCharPositionInLine() override { return lexer.column(); }
+    antlr4::CharStream* getInputStream() override { return nullptr; }
+    std::string getSourceName() override { return name; }
+    antlr4::TokenFactory<antlr4::CommonToken>* getTokenFactory() override;
+
+private:
+    NativeLexer lexer;
+    std::string name;
+    antlr4::ANTLRErrorListener* errorListener = nullptr;
+    size_t reportedErrors = 0;
+};
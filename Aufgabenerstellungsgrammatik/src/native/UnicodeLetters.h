@@ -0,0 +1,9 @@
+// ============================================================================
+// File: src/native/UnicodeLetters.h
+// ============================================================================
+#pragma once
+
+#include <cstdint>
+
+// true for code points in Unicode General_Category L (ANTLR's \p{L})
+bool isUnicodeLetter(uint32_t cp);